@@ -652,6 +652,15 @@ void config_setstd(struct RastaConfig *cfg) {
         cfg->values.redundancy.n_deferqueue_size = (unsigned short)entr.value.number;
     }
 
+    // udp offload
+    entr = config_get(cfg, "RASTA_UDP_OFFLOAD");
+    if (entr.type != DICTIONARY_NUMBER || entr.value.number < 0) {
+        // set std
+        cfg->values.redundancy.udp_offload = false;
+    } else {
+        cfg->values.redundancy.udp_offload = entr.value.number != 0;
+    }
+
     /*
      * General
      */
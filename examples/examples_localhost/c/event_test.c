@@ -1,5 +1,6 @@
 #include "../../../src/c/util/event_system.h"
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 
 #define SECOND_TO_NANO(s) s *(uint64_t)1000000000
@@ -46,6 +47,7 @@ int main() {
     last_time = test_get_nanotime();
     event_system ev_sys = {0};
     timed_event t_events[2];
+    memset(t_events, 0, sizeof(t_events));
     t_events[0].callback = send_heartbeat_event;
     t_events[0].interval = heartbeat_interval;
     t_events[0].carry_data = NULL;
@@ -59,6 +61,7 @@ int main() {
     add_timed_event(&ev_sys, &t_events[1]);
 
     fd_event f_events[1];
+    memset(f_events, 0, sizeof(f_events));
     f_events[0].callback = event_read;
     f_events[0].fd = STDIN_FILENO;
     f_events[0].carry_data = t_events + 1;
@@ -3,6 +3,7 @@
 
 #include "../logging.h"
 #include "../rastahandle.h"
+#include "../util/rmemory.h"
 
 #ifdef ENABLE_OPAQUE
 #include "key_exchange.h"
@@ -26,7 +27,7 @@ int key_exchange_prepare_credential_request(struct key_exchange_state *kex_state
                                             struct logger_t *logger) {
     const size_t password_length = strlen(psk);
     int ret;
-    uint8_t *client_secret = malloc(password_length + OPAQUE_USER_SESSION_SECRET_LEN);
+    uint8_t *client_secret = rmalloc_tagged(RASTA_MEMORY_TAG_KEX, password_length + OPAQUE_USER_SESSION_SECRET_LEN);
     if (!client_secret) {
         logger_log(logger, LOG_LEVEL_ERROR, "key_exchange:key_exchange_prepare_credential_request",
                    "Could not allocate %lu bytes for client secret!", password_length + OPAQUE_USER_SESSION_SECRET_LEN);
@@ -100,7 +101,7 @@ int kex_recover_credential(struct key_exchange_state *kex_state,
     if (munlock_ret) {
         logger_log(logger, LOG_LEVEL_ERROR, "kex_exchange:kex_recover_credential", "munlock failed: %s", strerror(errno));
     }
-    free(kex_state->client_secret);
+    rfree(kex_state->client_secret);
     kex_state->client_secret = NULL;
 
     return ret;
@@ -102,7 +102,7 @@ char *get_log_message_string(log_level max_log_level, log_level level, char *loc
     // add milliseconds to timestamp
     sprintf(timestamp2, "%s (Epoch time: %llu)", timestamp, millisecondsSinceEpoch);
 
-    char *msg_string = rmalloc(LOGGER_MAX_MSG_SIZE);
+    char *msg_string = rmalloc_tagged(RASTA_MEMORY_TAG_LOGGING, LOGGER_MAX_MSG_SIZE);
     sprintf(msg_string, LOG_FORMAT, timestamp2, level_str, location, msg_str);
 
     return msg_string;
@@ -31,17 +31,33 @@ void log_main_loop_state(struct rasta_handle *h, event_system *ev_sys, const cha
                message, fd_event_active_count, fd_event_count, timed_event_active_count, timed_event_count);
 }
 
+/**
+ * makes memory allocated by the stack on the calling thread come from the allocator of the instance
+ * and payloads from the buffer pool of the connection, until rmem_scope_leave is called
+ * @param user_configuration the RaSTA instance about to run on this thread
+ * @return the memory that was active before, e.g. that of another instance whose callback called this one
+ */
+static rmem_scope_t rasta_use_memory(rasta *user_configuration) {
+    return rmem_scope_enter(user_configuration->h.memory, user_configuration->h.rasta_connection->buffer_pool);
+}
+
 bool rasta_bind(rasta *user_configuration) {
-    return redundancy_mux_bind(&user_configuration->h);
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    bool result = redundancy_mux_bind(&user_configuration->h);
+    rmem_scope_leave(scope);
+    return result;
 }
 
 void rasta_listen(rasta *user_configuration) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
     sr_listen(&user_configuration->h);
+    rmem_scope_leave(scope);
 }
 
 rasta_connection *rasta_accept(rasta *user_configuration) {
     struct rasta_handle *h = &user_configuration->h;
     event_system *event_system = &user_configuration->rasta_lib_event_system;
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
 
     // Re-initialize the mux
     redundancy_mux_init(&h->mux);
@@ -51,12 +67,14 @@ rasta_connection *rasta_accept(rasta *user_configuration) {
     log_main_loop_state(h, event_system, "event-system started");
     event_system_start(event_system);
 
+    rasta_connection *result = NULL;
     if (h->rasta_connection->is_new) {
         h->rasta_connection->is_new = false;
-        return h->rasta_connection;
+        result = h->rasta_connection;
     }
 
-    return NULL;
+    rmem_scope_leave(scope);
+    return result;
 }
 
 int terminator_callback(void *carry, int fd) {
@@ -81,6 +99,8 @@ typedef struct rasta_cancellation {
 } rasta_cancellation;
 
 rasta_cancellation *rasta_prepare_cancellation(rasta *r) {
+    // may be called from the thread that cancels later, the buffer pool is not touched here
+    rmem_context_t *previous_context = rmem_context_activate(r->h.memory);
     logger_log(&r->logger, LOG_LEVEL_DEBUG, "RaSTA Cancel", "Allocating cancellation...");
     rasta_cancellation *result = rmalloc(sizeof(rasta_cancellation));
 
@@ -88,9 +108,10 @@ rasta_cancellation *rasta_prepare_cancellation(rasta *r) {
     if (pipe(result->fd) < 0) {
         perror("Failed to create pipe");
         rfree(result);
-        return NULL;
+        result = NULL;
     }
 
+    rmem_context_activate(previous_context);
     return result;
 }
 
@@ -113,7 +134,9 @@ rasta_connection *rasta_accept_with_cancel(rasta *r, rasta_cancellation *cancell
     close(cancellation->fd[1]);
 
     logger_log(&r->logger, LOG_LEVEL_DEBUG, "RaSTA Cancel", "Freeing cancellation...");
+    rmem_context_t *previous_context = rmem_context_activate(r->h.memory);
     rfree(cancellation);
+    rmem_context_activate(previous_context);
 
     return result;
 }
@@ -127,10 +150,17 @@ void rasta_cancel_operation(rasta *r, rasta_cancellation *cancel) {
 }
 
 rasta_connection *rasta_connect(rasta *user_configuration) {
-    return sr_connect(&user_configuration->h);
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    rasta_connection *connection = sr_connect(&user_configuration->h);
+    rmem_scope_leave(scope);
+    return connection;
 }
 
-int rasta_recv(rasta *user_configuration, rasta_connection *connection, void *buf, size_t len) {
+/**
+ * runs the event loop until a message is in the receive queue of the connection, the memory of the instance has to be active
+ * @return the first message of the queue or NULL if the connection is not up
+ */
+static struct sr_received_message *rasta_recv_wait(rasta *user_configuration, rasta_connection *connection) {
     struct rasta_handle *h = &user_configuration->h;
     event_system *event_system = &user_configuration->rasta_lib_event_system;
 
@@ -141,26 +171,153 @@ int rasta_recv(rasta *user_configuration, rasta_connection *connection, void *bu
 
     if (connection->current_state != RASTA_CONNECTION_UP) {
         // TODO: If sockets are broken, their event handlers have to be removed...
+        return NULL;
+    }
+
+    return fifo_pop(connection->fifo_receive);
+}
+
+int rasta_recv(rasta *user_configuration, rasta_connection *connection, void *buf, size_t len) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    struct sr_received_message *elem = rasta_recv_wait(user_configuration, connection);
+    if (elem == NULL) {
+        rmem_scope_leave(scope);
         return -1;
     }
 
-    struct RastaByteArray *elem;
-    elem = fifo_pop(connection->fifo_receive);
-    size_t received_len = (len < elem->length) ? len : elem->length;
+    size_t received_len = (len < elem->message.length) ? len : elem->message.length;
 
-    if (len < elem->length) {
+    if (len < elem->message.length) {
         logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA receive",
-                   "supplied buffer (%zd bytes) is smaller than message length (%d bytes) - received message may be incomplete!", len, elem->length);
+                   "supplied buffer (%zd bytes) is smaller than message length (%d bytes) - received message may be incomplete!", len, elem->message.length);
     }
 
-    rmemcpy(buf, elem->bytes, received_len);
-    freeRastaByteArray(elem);
-    rfree(elem);
+    rmemcpy(buf, elem->message.bytes, received_len);
+    sr_release_received_message(elem);
 
+    rmem_scope_leave(scope);
     return received_len;
 }
 
+int rasta_recv_borrow(rasta *user_configuration, rasta_connection *connection, rasta_message *message) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    struct sr_received_message *elem = rasta_recv_wait(user_configuration, connection);
+    rmem_scope_leave(scope);
+    if (elem == NULL) {
+        return -1;
+    }
+
+    message->data = elem->message.bytes;
+    message->length = elem->message.length;
+    message->handle = elem;
+    return 0;
+}
+
+void rasta_recv_release(rasta *user_configuration, rasta_message *message) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    if (message->handle != NULL) {
+        sr_release_received_message(message->handle);
+    }
+    message->data = NULL;
+    message->length = 0;
+    message->handle = NULL;
+    rmem_scope_leave(scope);
+}
+
+unsigned int rasta_recv_queue_size(rasta_connection *connection) {
+    return sr_recv_queue_item_count(connection);
+}
+
+int rasta_run_once(rasta *user_configuration, int timeout_ms) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    uint64_t timeout = timeout_ms < 0 ? UINT64_MAX : (uint64_t)timeout_ms * NS_PER_MS;
+    int result = event_system_run(&user_configuration->rasta_lib_event_system, timeout);
+    rmem_scope_leave(scope);
+    return result;
+}
+
+int rasta_get_fd(rasta *user_configuration) {
+    return event_system_fd(&user_configuration->rasta_lib_event_system);
+}
+
+int rasta_process_events(rasta *user_configuration) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    int result = event_system_run(&user_configuration->rasta_lib_event_system, 0);
+    rmem_scope_leave(scope);
+    return result;
+}
+
+int rasta_run(rasta *user_configuration) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    int result = 0;
+    user_configuration->running = true;
+    while (user_configuration->running) {
+        if (event_system_run(&user_configuration->rasta_lib_event_system, UINT64_MAX) == -1) {
+            user_configuration->running = false;
+            result = -1;
+        }
+    }
+    rmem_scope_leave(scope);
+    return result;
+}
+
+void rasta_stop(rasta *user_configuration) {
+    user_configuration->running = false;
+    event_system_stop(&user_configuration->rasta_lib_event_system);
+}
+
+void *rasta_send_reserve(rasta *user_configuration, rasta_connection *connection, size_t len) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    void *buf = sr_reserve_message(connection, len);
+    rmem_scope_leave(scope);
+    return buf;
+}
+
+int rasta_send_commit(rasta *user_configuration, rasta_connection *connection, void *buf, size_t len) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    int result = sr_send_reserved(&user_configuration->h, connection, buf, (unsigned int)len);
+    rmem_scope_leave(scope);
+    return result;
+}
+
+void rasta_send_abort(rasta *user_configuration, void *buf) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    sr_release_message(buf);
+    rmem_scope_leave(scope);
+}
+
+int rasta_submit(rasta_connection *connection, const void *buf, size_t len) {
+    if (len > sr_max_message_length(connection)) {
+        return -1;
+    }
+
+    // the buffer pool belongs to the event loop thread, producers allocate from the allocator of the instance
+    rmem_context_t *previous_context = rmem_context_activate(connection->memory);
+    struct RastaByteArray *msg = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, sizeof(struct RastaByteArray));
+    allocateRastaByteArrayFromPool(msg, len, NULL);
+    rmemcpy(msg->bytes, buf, len);
+
+    if (!mpsc_queue_push(connection->submit_queue, msg)) {
+        freeRastaByteArray(msg);
+        rfree(msg);
+        rmem_context_activate(previous_context);
+        return -1;
+    }
+    rmem_context_activate(previous_context);
+
+    // only the first message after the event loop drained the queue rings the doorbell
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!atomic_exchange(&connection->submit_pending, true)) {
+        uint64_t one = 1;
+        ssize_t ignored = write(connection->submit_fd[1], &one, sizeof(one));
+        (void)ignored;
+    }
+    return 0;
+}
+
 int rasta_send(rasta *user_configuration, rasta_connection *connection, void *buf, size_t len) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+
     struct RastaMessageData messageData1;
     allocateRastaMessageData(&messageData1, 1);
     messageData1.data_array[0].bytes = buf;
@@ -168,25 +325,67 @@ int rasta_send(rasta *user_configuration, rasta_connection *connection, void *bu
 
     int return_val = sr_send(&user_configuration->h, connection, messageData1);
     rfree(messageData1.data_array);
+    rmem_scope_leave(scope);
     return return_val;
 }
 
+void rasta_get_memory_stats(rasta *user_configuration, rasta_memory_stats *stats) {
+    rmem_context_stats(user_configuration->h.memory, stats);
+}
+
 void rasta_disconnect(rasta_connection *connection) {
+    rmem_scope_t scope = rmem_scope_enter(connection->memory, connection->buffer_pool);
     sr_disconnect(connection);
+    rmem_scope_leave(scope);
 }
 
 void rasta_cleanup(rasta *user_configuration) {
+    rmem_scope_t scope = rasta_use_memory(user_configuration);
+    rmem_pool_t *pool = user_configuration->h.rasta_connection->buffer_pool;
     sr_cleanup(&user_configuration->h);
 
+    retransmission_store_destroy(&user_configuration->h.rasta_connection->retransmission_store);
+    fifo_destroy(&user_configuration->h.rasta_connection->fifo_send);
+
+    struct sr_received_message *received;
+    while ((received = fifo_pop(user_configuration->h.rasta_connection->fifo_receive))) {
+        sr_release_received_message(received);
+    }
+    fifo_destroy(&user_configuration->h.rasta_connection->fifo_receive);
+
+    rasta_connection *connection = user_configuration->h.rasta_connection;
+    remove_fd_event(&user_configuration->rasta_lib_event_system, &connection->submit_event);
+    if (connection->submit_carry != NULL) {
+        freeRastaByteArray(connection->submit_carry);
+        rfree(connection->submit_carry);
+    }
     struct RastaByteArray *elem;
-    while ((elem = fifo_pop(user_configuration->h.rasta_connection->fifo_retransmission))) {
+    while ((elem = mpsc_queue_pop(connection->submit_queue))) {
         freeRastaByteArray(elem);
         rfree(elem);
     }
-    fifo_destroy(&user_configuration->h.rasta_connection->fifo_retransmission);
-    fifo_destroy(&user_configuration->h.rasta_connection->fifo_send);
-    fifo_destroy(&user_configuration->h.rasta_connection->fifo_receive);
+    mpsc_queue_destroy(&connection->submit_queue);
+    close(connection->submit_fd[0]);
+    if (connection->submit_fd[1] != connection->submit_fd[0]) {
+        close(connection->submit_fd[1]);
+    }
+
+    // blocks that are still in use keep the pool alive until they are freed
+    rmem_pool_destroy(&user_configuration->h.rasta_connection->buffer_pool);
 
     rfree(user_configuration->h.rasta_connection);
+    event_system_destroy(&user_configuration->rasta_lib_event_system);
+
+    rmem_context_t *memory = user_configuration->h.memory;
     rfree(user_configuration);
+
+    // the memory of this instance must not stay active, even if it was active before
+    if (scope.context == memory) {
+        scope.context = NULL;
+    }
+    if (scope.pool == pool) {
+        scope.pool = NULL;
+    }
+    rmem_context_destroy(&memory);
+    rmem_scope_leave(scope);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdatomic.h>
 #include <stdbool.h>
 
 #include <rasta/rastarole.h>
@@ -9,6 +10,8 @@
 #include "redundancy/rasta_redundancy_channel.h"
 #include "util/event_system.h"
 #include "util/fifo.h"
+#include "util/mpsc_queue.h"
+#include "util/retransmission_store.h"
 
 #define DIAGNOSTIC_INTERVAL_SIZE 500
 
@@ -160,10 +163,29 @@ typedef struct rasta_connection {
     fifo_t *fifo_send;
 
     /**
-     * queue for received messages that have not yet been rasta_recv()'d
+     * queue for received messages (struct sr_received_message) that have not yet been rasta_recv()'d
      */
     fifo_t *fifo_receive;
 
+    /**
+     * messages submitted with rasta_submit (from any thread), moved to fifo_send by the event loop
+     */
+    mpsc_queue_t *submit_queue;
+    /**
+     * doorbell waking up the event loop when messages have been submitted,
+     * [0] is read by submit_event, [1] is written by the producers (the same eventfd if available)
+     */
+    int submit_fd[2];
+    fd_event submit_event;
+    /**
+     * true while the doorbell has been rung but submit_event has not yet drained the queue
+     */
+    atomic_bool submit_pending;
+    /**
+     * submitted message that did not fit into fifo_send, it is queued before the messages still in submit_queue
+     */
+    struct RastaByteArray *submit_carry;
+
     /**
      * the N_SENDMAX of the connection partner,  -1 if not connected
      */
@@ -241,9 +263,20 @@ typedef struct rasta_connection {
     struct diagnostic_interval *diagnostic_intervals;
 
     /**
-     * the pdu fifo for retransmission purposes
+     * the sent pdus that are kept for retransmission until they are confirmed
+     */
+    retransmission_store_t *retransmission_store;
+
+    /**
+     * pool for the payloads of messages and PDUs in the queues of this connection,
+     * active on the thread running the event loop (see rmem_pool_activate)
+     */
+    rmem_pool_t *buffer_pool;
+
+    /**
+     * memory context of the RaSTA instance, activated by rasta_submit on the calling thread
      */
-    fifo_t *fifo_retransmission;
+    rmem_context_t *memory;
 
     /**
      *   the error counters as specified in 5.5.5
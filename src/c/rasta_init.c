@@ -1,5 +1,11 @@
+#include <fcntl.h>
 #include <memory.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+#ifdef USE_EVENTFD
+#include <sys/eventfd.h>
+#endif
 
 #include <rasta/rasta.h>
 
@@ -7,6 +13,7 @@
 #include "retransmission/safety_retransmission.h"
 #include "transport/events.h"
 #include "transport/transport.h"
+#include "util/rastakernels.h"
 #include "util/rastautil.h"
 #include "util/rmemory.h"
 
@@ -14,6 +21,16 @@
 // See section 5.5.10
 #define IO_INTERVAL 10
 
+// Amount of messages that can be submitted from other threads before the event loop picks them up
+#define SUBMIT_QUEUE_SIZE 4096
+
+// PDU header, message count and the largest safety code
+#define PDU_OVERHEAD (28 + 2 + 8)
+// Redundancy layer header and the largest check code
+#define REDUNDANCY_OVERHEAD (8 + 4)
+// Small payloads such as hash keys and PDUs without data (heartbeats, connection messages)
+#define SMALL_BUFFER_SIZE 64
+
 void init_connection_timeout_event(timed_event *ev, struct timed_event_data *carry_data,
                                    struct rasta_connection *connection) {
     memset(ev, 0, sizeof(timed_event));
@@ -61,6 +78,42 @@ void init_connection_events(struct rasta_handle *h, struct rasta_connection *con
 #endif
 }
 
+void init_submit_queue(struct rasta_handle *h, struct rasta_connection *connection) {
+    connection->submit_queue = mpsc_queue_init(SUBMIT_QUEUE_SIZE);
+    atomic_init(&connection->submit_pending, false);
+
+#ifdef USE_EVENTFD
+    connection->submit_fd[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    connection->submit_fd[1] = connection->submit_fd[0];
+    if (connection->submit_fd[0] < 0) {
+        perror("Failed to create eventfd");
+    }
+#else
+    if (pipe(connection->submit_fd) < 0) {
+        perror("Failed to create pipe");
+    }
+    fcntl(connection->submit_fd[0], F_SETFL, O_NONBLOCK);
+    fcntl(connection->submit_fd[1], F_SETFL, O_NONBLOCK);
+#endif
+
+    memset(&connection->submit_event, 0, sizeof(fd_event));
+    connection->submit_event.callback = data_submit_event;
+    connection->submit_event.carry_data = connection;
+    connection->submit_event.fd = connection->submit_fd[0];
+    enable_fd_event(&connection->submit_event);
+    add_fd_event(h->ev_sys, &connection->submit_event, EV_READABLE);
+}
+
+void init_buffer_pool(struct rasta_connection *connection) {
+    // size classes for single application messages and for complete data PDUs with max_packet messages
+    unsigned int max_msg_size = connection->config->receive.max_recv_msg_size;
+    unsigned int max_pdu_size = PDU_OVERHEAD + connection->config->sending.max_packet * (2 + max_msg_size);
+    unsigned int block_sizes[] = {SMALL_BUFFER_SIZE, max_msg_size, max_pdu_size, max_pdu_size + REDUNDANCY_OVERHEAD};
+
+    connection->buffer_pool = rmem_pool_init(block_sizes, sizeof(block_sizes) / sizeof(block_sizes[0]));
+    rmem_pool_activate(connection->buffer_pool);
+}
+
 void rasta_socket(rasta *user_configuration, rasta_config_info *config, struct logger_t *logger) {
     struct rasta_handle *handle = &user_configuration->h;
     rasta_handle_init(handle, config, logger);
@@ -70,9 +123,24 @@ void rasta_socket(rasta *user_configuration, rasta_config_info *config, struct l
 }
 
 rasta *rasta_lib_init_configuration(rasta_config_info *config, log_level log_level, logger_type logger_type) {
+    return rasta_lib_init_configuration_with_allocator(config, log_level, logger_type, NULL);
+}
+
+rasta *rasta_lib_init_configuration_with_allocator(rasta_config_info *config, log_level log_level, logger_type logger_type,
+                                                   const rasta_allocator *allocator) {
+    // everything from here on is allocated with the allocator of the instance,
+    // the pool of another instance must not be used until the pool of this one exists
+    rmem_context_t *memory = rmem_context_init(allocator);
+    rmem_scope_t scope = rmem_scope_enter(memory, NULL);
+
     rasta *user_configuration = rmalloc(sizeof(rasta));
     memset(user_configuration, 0, sizeof(rasta));
+    user_configuration->h.memory = memory;
     logger_init(&user_configuration->logger, log_level, logger_type);
+
+    // select the safety code and CRC kernels for this CPU before the first PDU
+    rasta_kernels_init(&user_configuration->logger);
+
     rasta_socket(user_configuration, config, &user_configuration->logger);
     memset(&user_configuration->rasta_lib_event_system, 0, sizeof(user_configuration->rasta_lib_event_system));
 
@@ -95,6 +163,10 @@ rasta *rasta_lib_init_configuration(rasta_config_info *config, log_level log_lev
     connection->remote_id = config->general.rasta_id_remote;
     connection->my_id = (uint32_t)connection->config->general.rasta_id;
     connection->network_id = (uint32_t)connection->config->general.rasta_network;
+    connection->memory = memory;
+
+    // payloads allocated from here on come from the pool of the connection
+    init_buffer_pool(connection);
 
     // This is a little hacky
     connection->redundancy_channel = h->mux.redundancy_channel;
@@ -129,8 +201,8 @@ rasta *rasta_lib_init_configuration(rasta_config_info *config, log_level log_lev
     connection->receive_handle.logger = &user_configuration->logger;
     connection->receive_handle.hashing_context = &h->mux.sr_hashing_context;
 
-    // init retransmission fifo
-    connection->fifo_retransmission = fifo_init(connection->config->retransmission.max_retransmission_queue_size);
+    // init retransmission store
+    connection->retransmission_store = retransmission_store_init(connection->config->retransmission.max_retransmission_queue_size);
 
     // create send queue
     connection->fifo_send = fifo_init(2 * connection->config->sending.max_packet);
@@ -138,7 +210,11 @@ rasta *rasta_lib_init_configuration(rasta_config_info *config, log_level log_lev
     // init receive queue
     connection->fifo_receive = fifo_init(connection->config->receive.max_recvqueue_size);
 
+    // queue for messages submitted from other threads
+    init_submit_queue(h, connection);
+
     init_connection_events(h, connection);
 
+    rmem_scope_leave(scope);
     return user_configuration;
 }
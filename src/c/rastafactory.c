@@ -12,7 +12,7 @@ rasta_error_type rastafactoryLastError = RASTA_ERRORS_NONE;
 
 void allocateRastaMessageData(struct RastaMessageData *data, unsigned int count) {
     data->count = count;
-    data->data_array = rmalloc(sizeof(struct RastaByteArray) * count);
+    data->data_array = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, sizeof(struct RastaByteArray) * count);
 }
 
 void freeRastaMessageData(struct RastaMessageData *data) {
@@ -400,7 +400,7 @@ struct RastaPacket createRetransmittedDataMessage(uint32_t receiver_id, uint32_t
     return result;
 }
 
-void createRedundancyPacket(uint32_t sequence_number, struct RastaPacket *inner_data, struct crc_options checksum_type, struct RastaRedundancyPacket *packet) {
+void createRedundancyPacket(uint32_t sequence_number, struct RastaPacket *inner_data, struct crc_options *checksum_type, struct RastaRedundancyPacket *packet) {
     packet->sequence_number = sequence_number;
     packet->data = *inner_data;
     packet->checksum_type = checksum_type;
@@ -410,7 +410,7 @@ void createRedundancyPacket(uint32_t sequence_number, struct RastaPacket *inner_
 
     // length = 2 bytes length field + 2 bytes reserve + 4 bytes seq. nr. + inner data length + checksum length
     // checksum width in crc_options is in bit, so divide by 8 for bytes
-    packet->length = (uint16_t)(8 + inner_data->length + (checksum_type.width / 8));
+    packet->length = (uint16_t)(8 + inner_data->length + (checksum_type->width / 8));
 
     // set checksum_correct to 1 as checksum will be calculated on conversion to bytes
     packet->checksum_correct = 1;
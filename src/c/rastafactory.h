@@ -246,7 +246,7 @@ struct RastaMessageData extractMessageData(struct RastaPacket *p);
  * creates a redundancy PDU carrying the specified @p inner_data
  * @param sequence_number the sequence number of the PDU
  * @param inner_data the SR-layer packet that is contained in the PDU
- * @param checksum_type the options for the CRC algorithm that will be used to calculate the checksum
+ * @param checksum_type the options for the CRC algorithm that will be used to calculate the checksum, referenced by the PDU
  * @param packet the RaSTA redundancy layer PDU to create
  */
-void createRedundancyPacket(uint32_t sequence_number, struct RastaPacket *inner_data, struct crc_options checksum_type, struct RastaRedundancyPacket *packet);
+void createRedundancyPacket(uint32_t sequence_number, struct RastaPacket *inner_data, struct crc_options *checksum_type, struct RastaRedundancyPacket *packet);
@@ -10,6 +10,7 @@
 #include "redundancy/rasta_red_multiplexer.h"
 #include "util/event_system.h"
 #include "util/rastahashing.h"
+#include "util/rmemory.h"
 
 #ifdef ENABLE_OPAQUE
 #include <opaque.h>
@@ -47,12 +48,21 @@ typedef struct rasta_handle {
     rasta_connection *rasta_connection;
 
     struct rasta_connection *accepted_connection;
+
+    /**
+     * the allocator and allocation counters of this instance
+     */
+    rmem_context_t *memory;
 } rasta_handle;
 
 typedef struct rasta {
     struct logger_t logger;
     struct rasta_handle h;
     event_system rasta_lib_event_system;
+    /**
+     * true while rasta_run is running, cleared by rasta_stop
+     */
+    bool running;
 } rasta;
 
 typedef struct rasta_sending_handle {
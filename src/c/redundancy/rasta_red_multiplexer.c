@@ -126,18 +126,7 @@ void handle_received_data(redundancy_mux *mux, unsigned char *buffer, ssize_t le
     incomingData.length = (unsigned int)len;
     incomingData.bytes = buffer;
 
-    rasta_hashing_context_t test;
-    struct crc_options options;
-
-    test.hash_length = mux->sr_hashing_context.hash_length;
-    test.algorithm = mux->sr_hashing_context.algorithm;
-    allocateRastaByteArray(&test.key, mux->sr_hashing_context.key.length);
-    rmemcpy(test.key.bytes, mux->sr_hashing_context.key.bytes, mux->sr_hashing_context.key.length);
-    rmemcpy(&options, &mux->config->redundancy.crc_type, sizeof(mux->config->redundancy.crc_type));
-
-    bytesToRastaRedundancyPacket(incomingData, options, &test, receivedPacket);
-
-    freeRastaByteArray(&test.key);
+    bytesToRastaRedundancyPacket(incomingData, &mux->redundancy_channel->decode_context, receivedPacket);
 }
 
 int channel_timeout_event(void *carry_data, int fd) {
@@ -179,6 +168,7 @@ void redundancy_mux_allocate_channels(struct rasta_handle *h, redundancy_mux *mu
     assert(config->redundancy_remote.connections.count == mux->port_count);
     redundancy_channel_alloc(h, mux->logger, config, mux->redundancy_channel);
     mux->redundancy_channel->mux = mux;
+    rasta_decode_context_init(&mux->redundancy_channel->decode_context, &mux->redundancy_channel->checksum_type, &mux->sr_hashing_context);
 }
 
 void redundancy_mux_alloc(struct rasta_handle *h, redundancy_mux *mux, struct logger_t *logger, rasta_config_info *config) {
@@ -188,6 +178,7 @@ void redundancy_mux_alloc(struct rasta_handle *h, redundancy_mux *mux, struct lo
     mux->listen_ports = rmalloc(sizeof(uint16_t) * mux->port_count);
     mux->config = config;
     mux->notifications_running = 0;
+    mux->cork_depth = 0;
 
     // init notifications to NULL
     mux->notifications.on_diagnostics_available = NULL;
@@ -211,6 +202,7 @@ void redundancy_mux_alloc(struct rasta_handle *h, redundancy_mux *mux, struct lo
         mux->sr_hashing_context.key.bytes[1] = (config->sending.sr_hash_key >> 16) & 0xFF;
         mux->sr_hashing_context.key.bytes[2] = (config->sending.sr_hash_key >> 8) & 0xFF;
         mux->sr_hashing_context.key.bytes[3] = (config->sending.sr_hash_key) & 0xFF;
+        rasta_hashing_context_prepare(&mux->sr_hashing_context);
     }
 
     redundancy_mux_allocate_channels(h, mux, config);
@@ -244,22 +236,11 @@ void redundancy_mux_close(redundancy_mux *mux) {
     freeRastaByteArray(&mux->sr_hashing_context.key);
 }
 
-void redundancy_mux_send(rasta_redundancy_channel *receiver, struct RastaPacket *data, rasta_role role) {
+/**
+ * sends a serialized redundancy layer PDU on every transport channel of the redundancy channel
+ */
+static void redundancy_mux_send_bytes(rasta_redundancy_channel *receiver, struct RastaByteArray data_to_send, rasta_role role) {
     redundancy_mux *mux = receiver->mux;
-    logger_log(mux->logger, LOG_LEVEL_DEBUG, "RaSTA RedMux send", "sending a data packet to id 0x%lX",
-               (long unsigned int)data->receiver_id);
-
-    logger_log(mux->logger, LOG_LEVEL_DEBUG, "RaSTA RedMux send", "current seq_tx=%lu", receiver->seq_tx);
-
-    // create packet to send and convert to byte array
-    struct RastaRedundancyPacket packet;
-    createRedundancyPacket(receiver->seq_tx, data, mux->config->redundancy.crc_type, &packet);
-    struct RastaByteArray data_to_send = rastaRedundancyPacketToBytes(&packet, &receiver->hashing_context);
-
-    logger_log(mux->logger, LOG_LEVEL_DEBUG, "RaSTA RedMux send", "redundancy packet created");
-
-    // increase seq_tx
-    receiver->seq_tx = receiver->seq_tx + 1;
 
     // send on every transport channel
     for (unsigned int i = 0; i < receiver->transport_channel_count; ++i) {
@@ -292,9 +273,79 @@ void redundancy_mux_send(rasta_redundancy_channel *receiver, struct RastaPacket
                    channel->remote_ip_address, channel->remote_port);
     }
 
+    logger_log(mux->logger, LOG_LEVEL_DEBUG, "RaSTA Red send", "Data sent over all transport channels");
+}
+
+void redundancy_mux_send(rasta_redundancy_channel *receiver, struct RastaPacket *data, rasta_role role) {
+    redundancy_mux *mux = receiver->mux;
+    logger_log(mux->logger, LOG_LEVEL_DEBUG, "RaSTA RedMux send", "sending a data packet to id 0x%lX",
+               (long unsigned int)data->receiver_id);
+
+    logger_log(mux->logger, LOG_LEVEL_DEBUG, "RaSTA RedMux send", "current seq_tx=%lu", receiver->seq_tx);
+
+    // create packet to send and convert to byte array
+    struct RastaRedundancyPacket packet;
+    createRedundancyPacket(receiver->seq_tx, data, &receiver->checksum_type, &packet);
+    struct RastaByteArray data_to_send = rastaRedundancyPacketToBytes(&packet, &receiver->hashing_context);
+
+    logger_log(mux->logger, LOG_LEVEL_DEBUG, "RaSTA RedMux send", "redundancy packet created");
+
+    // increase seq_tx
+    receiver->seq_tx = receiver->seq_tx + 1;
+
+    redundancy_mux_send_bytes(receiver, data_to_send, role);
+
     freeRastaByteArray(&data_to_send);
+}
 
-    logger_log(mux->logger, LOG_LEVEL_DEBUG, "RaSTA Red send", "Data sent over all transport channels");
+void redundancy_mux_send_sealed(rasta_redundancy_channel *receiver, struct RastaPacket *data, unsigned char *bytes, rasta_role role) {
+    redundancy_mux *mux = receiver->mux;
+    logger_log(mux->logger, LOG_LEVEL_DEBUG, "RaSTA RedMux send", "sending a data packet to id 0x%lX in place, current seq_tx=%lu",
+               (long unsigned int)data->receiver_id, receiver->seq_tx);
+
+    struct RastaRedundancyPacket packet;
+    createRedundancyPacket(receiver->seq_tx, data, &receiver->checksum_type, &packet);
+    rastaRedundancySealBytes(&packet, bytes);
+
+    // increase seq_tx
+    receiver->seq_tx = receiver->seq_tx + 1;
+
+    struct RastaByteArray data_to_send;
+    data_to_send.bytes = bytes;
+    data_to_send.length = packet.length;
+    redundancy_mux_send_bytes(receiver, data_to_send, role);
+}
+
+bool redundancy_mux_can_send(rasta_redundancy_channel *channel) {
+    bool connected = false;
+    for (unsigned int i = 0; i < channel->transport_channel_count; ++i) {
+        rasta_transport_channel *transport_channel = &channel->transport_channels[i];
+        if (transport_channel->connected) {
+            if (transport_can_send(transport_channel)) {
+                return true;
+            }
+            connected = true;
+        }
+    }
+
+    // without a connected transport channel, sending redials or skips the channels as before
+    return !connected;
+}
+
+void redundancy_mux_cork(redundancy_mux *mux) {
+    if (mux->cork_depth++ == 0) {
+        for (unsigned int i = 0; i < mux->port_count; ++i) {
+            transport_cork(&mux->transport_sockets[i]);
+        }
+    }
+}
+
+void redundancy_mux_flush(redundancy_mux *mux) {
+    if (--mux->cork_depth == 0) {
+        for (unsigned int i = 0; i < mux->port_count; ++i) {
+            transport_flush(&mux->transport_sockets[i]);
+        }
+    }
 }
 
 // TODO: Remove this and next method because it scares me. Only used from tests though.
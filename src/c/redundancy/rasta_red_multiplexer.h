@@ -74,6 +74,11 @@ struct redundancy_mux {
      * Hashing paramenter for SR layer checksum
      */
     rasta_hashing_context_t sr_hashing_context;
+
+    /**
+     * nesting depth of redundancy_mux_cork calls, the transport sockets are flushed when it drops to 0
+     */
+    unsigned int cork_depth;
 };
 
 /**
@@ -104,6 +109,37 @@ void redundancy_mux_close(redundancy_mux *mux);
  */
 void redundancy_mux_send(rasta_redundancy_channel *channel, struct RastaPacket *data, rasta_role role);
 
+/**
+ * send a RaSTA packet that is already serialized and sealed at offset 8 of a buffer on a given redundancy channel,
+ * the redundancy header and checksum are written into the buffer around it
+ * @param channel the redundancy channel to send on
+ * @param data the fields of the packet to send
+ * @param bytes the buffer, with 8 bytes headroom and room for the checksum behind the packet
+ * @param role whether to send as a client or server
+ */
+void redundancy_mux_send_sealed(rasta_redundancy_channel *channel, struct RastaPacket *data, unsigned char *bytes, rasta_role role);
+
+/**
+ * check whether a PDU can be sent on the redundancy channel without queueing it behind a backlog. This is the case if
+ * at least one connected transport channel accepts more data, so a stalled transport channel does not hold up the others.
+ * @param channel the redundancy channel
+ * @return true if application data can be sent, false if it should be held back
+ */
+bool redundancy_mux_can_send(rasta_redundancy_channel *channel);
+
+/**
+ * queue the PDUs that are sent via the multiplexer until the matching call to redundancy_mux_flush, so the
+ * transport can send them together. Calls can be nested.
+ * @param mux the multiplexer
+ */
+void redundancy_mux_cork(redundancy_mux *mux);
+
+/**
+ * end a redundancy_mux_cork scope, the queued PDUs are sent when the outermost scope ends
+ * @param mux the multiplexer
+ */
+void redundancy_mux_flush(redundancy_mux *mux);
+
 /**
  * listen on all transport sockets of the given multiplexer
  * @param mux the mux used for listening
@@ -21,7 +21,7 @@ void redundancy_channel_init(rasta_redundancy_channel *channel) {
     deferqueue_clear(&channel->defer_q);
 
     // init diagnostics buffer
-    deferqueue_clear(&channel->diagnostics_packet_buffer);
+    diagnostics_window_clear(&channel->diagnostics_window);
 }
 
 int redundancy_channel_connect(redundancy_mux *mux, rasta_redundancy_channel *channel) {
@@ -61,16 +61,17 @@ void redundancy_channel_alloc(struct rasta_handle *h, struct logger_t *logger, c
 
     channel->logger = logger;
     channel->configuration_parameters = config->redundancy;
+    channel->checksum_type = config->redundancy.crc_type;
 
     // init sequence numbers
     channel->seq_rx = 0;
     channel->seq_tx = 0;
 
-    // init defer queue
-    channel->defer_q = deferqueue_init(config->redundancy.n_deferqueue_size);
+    // init defer queue, PDUs are accepted up to seq_rx + 10 * n_deferqueue_size
+    channel->defer_q = deferqueue_init(config->redundancy.n_deferqueue_size, 10 * config->redundancy.n_deferqueue_size + 1);
 
     // init diagnostics buffer
-    channel->diagnostics_packet_buffer = deferqueue_init(10 * config->redundancy.n_deferqueue_size);
+    channel->diagnostics_window = diagnostics_window_init(10 * config->redundancy.n_deferqueue_size);
 
     // init hashing context
     channel->hashing_context.hash_length = config->sending.md4_type;
@@ -89,6 +90,7 @@ void redundancy_channel_alloc(struct rasta_handle *h, struct logger_t *logger, c
         channel->hashing_context.key.bytes[1] = (config->sending.sr_hash_key >> 16) & 0xFF;
         channel->hashing_context.key.bytes[2] = (config->sending.sr_hash_key >> 8) & 0xFF;
         channel->hashing_context.key.bytes[3] = (config->sending.sr_hash_key) & 0xFF;
+        rasta_hashing_context_prepare(&channel->hashing_context);
     }
 
     // init transport channel buffer;
@@ -105,12 +107,15 @@ void redundancy_channel_alloc(struct rasta_handle *h, struct logger_t *logger, c
 
 void redundancy_channel_free(rasta_redundancy_channel *channel) {
     // destroy the diagnostics buffer
-    deferqueue_destroy(&channel->diagnostics_packet_buffer);
+    diagnostics_window_destroy(&channel->diagnostics_window);
 
     // destroy the defer queue
     deferqueue_destroy(&channel->defer_q);
 
     // free the channels
+    for (unsigned int i = 0; i < channel->transport_channel_count; i++) {
+        transport_free_channel(&channel->transport_channels[i]);
+    }
     rfree(channel->transport_channels);
     channel->transport_channel_count = 0;
 
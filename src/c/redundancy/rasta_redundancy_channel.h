@@ -2,6 +2,7 @@
 
 #include <rasta/config.h>
 
+#include "../util/diagnostics_window.h"
 #include "../util/rastadeferqueue.h"
 
 typedef struct redundancy_mux redundancy_mux;
@@ -26,6 +27,11 @@ typedef struct rasta_redundancy_channel {
      */
     struct crc_options checksum_type;
 
+    /**
+     * the parameters for decoding the PDUs received on this channel
+     */
+    rasta_decode_context_t decode_context;
+
     /**
      * next sequence number to send
      */
@@ -42,9 +48,9 @@ typedef struct rasta_redundancy_channel {
     struct defer_queue defer_q;
 
     /**
-     * used to store all received packets within a diagnose window
+     * receive times of the packets that were received first on this channel within a diagnose window
      */
-    struct defer_queue diagnostics_packet_buffer;
+    struct diagnostics_window diagnostics_window;
 
     /**
      * the transport channels of the partner (client) when running in server mode.
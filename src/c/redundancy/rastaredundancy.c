@@ -13,12 +13,6 @@
 #include "../util/rmemory.h"
 #include "rasta_redundancy_channel.h"
 
-int _deliver_message_to_upper_layer(rasta_connection *h, rasta_redundancy_channel *channel, struct RastaByteArray message) {
-    struct RastaPacket packet;
-    bytesToRastaPacket(message, &channel->hashing_context, &packet);
-    return sr_receive(h, &packet);
-}
-
 /**
  * delivers a message in the defer queue to next layer i.e. adds it to the receive buffer
  * see 6.6.4.4.6 for more details
@@ -33,18 +27,15 @@ int red_f_deliverDeferQueue(rasta_connection *con, rasta_redundancy_channel *cha
         logger_log(channel->logger, LOG_LEVEL_DEBUG, "RaSTA Red deliver deferq", "deferq contains seq_pdu=%lu",
                    channel->seq_rx);
 
-        struct RastaByteArray innerPackerBytes;
-        // convert inner data (RaSTA SR layer PDU) to byte array
         struct RastaRedundancyPacket queuePacket = deferqueue_get(&channel->defer_q, channel->seq_rx);
-        innerPackerBytes = rastaModuleToBytes(&queuePacket.data, &channel->hashing_context);
-        result |= _deliver_message_to_upper_layer(con, channel, innerPackerBytes);
-        freeRastaByteArray(&innerPackerBytes);
 
         // remove message from queue (effectively a pop operation with the get call)
         deferqueue_remove(&channel->defer_q, channel->seq_rx);
         logger_log(channel->logger, LOG_LEVEL_DEBUG, "RaSTA Red deliver deferq", "remove message from deferq");
 
-        freeRastaByteArray(&queuePacket.data.data);
+        // the inner RaSTA SR layer PDU was parsed and its safety code checked when it was received,
+        // the SR layer takes over its data
+        result |= sr_receive(con, &queuePacket.data);
         freeRastaByteArray(&queuePacket.data.checksum);
 
         // increase seq_rx
@@ -89,7 +80,7 @@ int red_f_receiveData(rasta_redundancy_channel *channel, struct RastaRedundancyP
         { // Diagnostics
             // -> calculate delay by looking for the received ts in diagnostics queue
 
-            unsigned long ts = deferqueue_get_ts(&channel->diagnostics_packet_buffer, packet.sequence_number);
+            unsigned long ts = diagnostics_window_get_ts(&channel->diagnostics_window, packet.sequence_number);
             if (ts != 0) {
                 // seq_pdu was in queue, received time is ts
                 unsigned long delay = cur_timestamp() - ts;
@@ -115,10 +106,8 @@ int red_f_receiveData(rasta_redundancy_channel *channel, struct RastaRedundancyP
                    channel_id, (long unsigned int)packet.sequence_number, channel->seq_rx - 1);
 
         { // Diagnostics
-            // received packet as first transport channel -> add with ts to diagnostics buffer
-            if (!deferqueue_add(&channel->diagnostics_packet_buffer, packet, cur_timestamp())) {
-                logger_log(channel->logger, LOG_LEVEL_INFO, "RaSTA Red receive", "diagnostics packet buffer is full");
-            }
+            // received packet as first transport channel -> remember its ts in the diagnostics window
+            diagnostics_window_add(&channel->diagnostics_window, packet.sequence_number, cur_timestamp());
         }
 
         // Here we deviate a bit from the flow diagram in the docs, because also insert in-order
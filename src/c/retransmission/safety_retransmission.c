@@ -52,26 +52,41 @@ void sr_diagnostic_update(struct rasta_connection *connection, struct RastaPacke
     }
 }
 
-void sr_add_app_messages_to_buffer(struct rasta_connection *con, struct RastaPacket *packet) {
-    struct RastaMessageData received_data;
-    received_data = extractMessageData(packet);
+static void sr_received_pdu_release(struct sr_received_pdu *pdu) {
+    if (--pdu->references == 0) {
+        freeRastaByteArray(&pdu->data);
+        rfree(pdu);
+    }
+}
 
-    logger_log(con->logger, LOG_LEVEL_DEBUG, "RaSTA add to buffer", "received %d application messages", received_data.count);
+void sr_add_app_messages_to_buffer(struct rasta_connection *con, struct RastaPacket *packet) {
+    // the messages in the receive queue are views into the data of the packet, which is kept until the last one is released
+    struct sr_received_pdu *pdu = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, sizeof(struct sr_received_pdu));
+    pdu->data = packet->data;
+    pdu->references = 1;
+
+    unsigned int current_length = 0;
+    while (current_length + 2 <= pdu->data.length) {
+        const uint16_t length = leShortToHost(&pdu->data.bytes[current_length]);
+        if (current_length + 2 + length > pdu->data.length) {
+            logger_log(con->logger, LOG_LEVEL_INFO, "RaSTA add to buffer", "discarding truncated application message");
+            break;
+        }
 
-    for (unsigned int i = 0; i < received_data.count; ++i) {
         if (fifo_full(con->fifo_receive)) {
-            logger_log(con->logger, LOG_LEVEL_INFO, "RaSTA add to buffer", "discarding %d application messages because receive queue is full", received_data.count - i);
+            logger_log(con->logger, LOG_LEVEL_INFO, "RaSTA add to buffer", "discarding application messages because receive queue is full");
             break;
         }
 
         // push into queue
-        struct RastaByteArray *to_fifo = rmalloc(sizeof(struct RastaByteArray));
-        allocateRastaByteArray(to_fifo, received_data.data_array[i].length);
-        rmemcpy(to_fifo->bytes, received_data.data_array[i].bytes, received_data.data_array[i].length);
+        struct sr_received_message *to_fifo = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, sizeof(struct sr_received_message));
+        to_fifo->message.bytes = &pdu->data.bytes[current_length + 2];
+        to_fifo->message.length = length;
+        to_fifo->pdu = pdu;
+        pdu->references++;
+        fifo_push(con->fifo_receive, to_fifo);
 
-        if (!fifo_push(con->fifo_receive, to_fifo)) {
-            logger_log(con->logger, LOG_LEVEL_INFO, "RaSTA add to buffer", "could not insert message into receive queue because it is full");
-        }
+        current_length += length + 2;
 
         // fire onReceive event
         fire_on_receive(sr_create_notification_result(NULL, con));
@@ -80,41 +95,31 @@ void sr_add_app_messages_to_buffer(struct rasta_connection *con, struct RastaPac
         sr_diagnostic_update(con, packet, &con->config->sending);
     }
 
-    freeRastaByteArray(&packet->data);
-    freeRastaByteArray(&packet->checksum);
-    freeRastaMessageData(&received_data);
+    // drop the reference of this function, frees the data if no message was queued
+    sr_received_pdu_release(pdu);
+}
+
+void sr_release_received_message(struct sr_received_message *message) {
+    sr_received_pdu_release(message->pdu);
+    rfree(message);
 }
 
 void sr_remove_confirmed_messages(struct rasta_connection *con) {
     // remove confirmed messages from retransmission fifo
     logger_log(con->logger, LOG_LEVEL_DEBUG, "RaSTA remove confirmed", "confirming messages with SN_PDU <= %lu", (long unsigned int)con->cs_r);
 
-    struct RastaByteArray *elem;
-    while ((elem = fifo_pop(con->fifo_retransmission)) != NULL) {
-        struct RastaPacket packet;
-        bytesToRastaPacket(*elem, &con->redundancy_channel->hashing_context, &packet);
-        logger_log(con->logger, LOG_LEVEL_DEBUG, "RaSTA remove confirmed", "removing packet with sn = %lu",
-                   (long unsigned int)packet.sequence_number);
-
-        freeRastaByteArray(elem);
-        freeRastaByteArray(&packet.data);
-        rfree(elem);
-
-        // message is confirmed when CS_R - SN_PDU >= 0
-        // equivalent to SN_PDU <= CS_R
-        if (packet.sequence_number == con->cs_r) {
-            // this packet has the last same sequence number as the confirmed sn, i.e. the next packet in the queue's
-            // SN_PDU will be bigger than CS_R (because of FIFO property of mqueue)
-            // that means we removed all confirmed messages and have to leave the loop to stop removing packets
-            logger_log(con->logger, LOG_LEVEL_DEBUG, "RaSTA remove confirmed", "last confirmed packet removed");
-            break;
-        }
-    }
+    unsigned int removed = retransmission_store_confirm(con->retransmission_store, con->cs_r);
+    logger_log(con->logger, LOG_LEVEL_DEBUG, "RaSTA remove confirmed", "removed %u confirmed packets", removed);
 
     // sending is now possible again (space in the retransmission queue is available), so we should trigger it
     if (fifo_full(con->fifo_send)) {
         data_send_event(&con->send_handle, -1);
     }
+
+    // submitted messages that did not fit into the send queue can follow now
+    if (con->submit_carry != NULL) {
+        sr_queue_submitted(con);
+    }
 }
 
 /* ----- processing of received packet types ----- */
@@ -280,77 +285,62 @@ void sr_init_connection(struct rasta_connection *connection, rasta_role role) {
 #endif
 }
 
-void sr_retransmit_data(rasta_connection *connection) {
+static void sr_send_sealed_pdu(struct rasta_connection *con, struct RastaPacket *data, struct RastaByteArray buffer);
 
-    // prepare Array Buffer
-    struct RastaByteArray packets[connection->config->retransmission.max_retransmission_queue_size];
-
-    int buffer_n = 0; // how many valid elements are in the buffer
-    buffer_n = fifo_get_size(connection->fifo_retransmission);
-    logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA retransmission", "found %d unconfirmed packets", buffer_n);
-
-    // get all packets and store them in the buffer
-    for (int j = 0; j < buffer_n; ++j) {
-        struct RastaByteArray *element;
-        element = fifo_pop(connection->fifo_retransmission);
-
-        allocateRastaByteArray(&packets[j], element->length);
-        rmemcpy(packets[j].bytes, element->bytes, element->length);
-
-        freeRastaByteArray(element);
-        rfree(element);
-    }
-
-    // re-open fifo in write mode
-    // now retransmit each packet in the buffer with new sequence numbers
-    for (int i = 0; i < buffer_n; i++) {
-        logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA retransmission", "retransmit packet %d", i);
-
-        // retrieve retransmission data to
-        struct RastaPacket old_p;
-        bytesToRastaPacket(packets[i], &connection->redundancy_channel->hashing_context, &old_p);
-        logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA retransmission", "convert packet %d to packet structure", i);
-
-        struct RastaMessageData app_messages = extractMessageData(&old_p);
-        logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA retransmission", "extract data from packet %d ", i);
-
-        // create new packet for retransmission
-        struct RastaPacket data = createRetransmittedDataMessage(connection->remote_id, connection->my_id, connection->sn_t,
-                                                                 connection->cs_t, cur_timestamp(), connection->ts_r,
-                                                                 app_messages, &connection->redundancy_channel->hashing_context);
-        logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA retransmission", "created retransmission packet %d ", i);
+void sr_retransmit_data(rasta_connection *connection) {
 
-        struct RastaByteArray new_p = rastaModuleToBytes(&data, &connection->redundancy_channel->hashing_context);
+    unsigned int buffer_n = retransmission_store_size(connection->retransmission_store);
+    logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA retransmission", "found %u unconfirmed packets", buffer_n);
+
+    rasta_hashing_context_t *hashing_context = &connection->redundancy_channel->hashing_context;
+
+    // now retransmit each packet in the store with new sequence numbers, only the header fields and the safety code
+    // are rewritten in the stored bytes. The retransmitted packets are added behind the ones that are still to be retransmitted.
+    // The safety codes of a group of packets are calculated together
+    for (unsigned int i = 0; i < buffer_n; i += RASTA_HASH_BATCH_SIZE) {
+        unsigned int n = buffer_n - i < RASTA_HASH_BATCH_SIZE ? buffer_n - i : RASTA_HASH_BATCH_SIZE;
+        struct RastaPacket packets[RASTA_HASH_BATCH_SIZE];
+        struct RastaByteArray buffers[RASTA_HASH_BATCH_SIZE];
+        unsigned char *pdus[RASTA_HASH_BATCH_SIZE];
+        unsigned long old_sequence_numbers[RASTA_HASH_BATCH_SIZE];
+        uint32_t timestamp = cur_timestamp();
+
+        for (unsigned int j = 0; j < n; j++) {
+            struct retransmission_entry entry;
+            retransmission_store_pop(connection->retransmission_store, &entry);
+
+            struct RastaByteArray buffer = entry.buffer;
+            if (entry.offset != SR_PDU_OFFSET) {
+                // no room for the redundancy layer around the PDU
+                buffer = sr_allocate_pdu_buffer(connection, entry.length);
+                rmemcpy(&buffer.bytes[SR_PDU_OFFSET], &entry.buffer.bytes[entry.offset], entry.length);
+                freeRastaByteArray(&entry.buffer);
+            }
 
-        // add packet to retrFifo again
-        struct RastaByteArray *to_fifo = rmalloc(sizeof(struct RastaByteArray));
-        allocateRastaByteArray(to_fifo, new_p.length);
-        rmemcpy(to_fifo->bytes, new_p.bytes, new_p.length);
-        if (fifo_push(connection->fifo_retransmission, to_fifo)) {
-            logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA retransmission", "added packet %d to queue", i);
-        } else {
-            logger_log(connection->logger, LOG_LEVEL_ERROR, "RaSTA retransmission", "could not add packet to full queue");
+            struct RastaPacket *data = &packets[j];
+            data->length = (uint16_t)entry.length;
+            data->type = RASTA_TYPE_RETRDATA;
+            data->receiver_id = connection->remote_id;
+            data->sender_id = connection->my_id;
+            data->sequence_number = connection->sn_t + j;
+            data->confirmed_sequence_number = connection->cs_t;
+            data->timestamp = timestamp;
+            data->confirmed_timestamp = connection->ts_r;
+            data->data.bytes = &buffer.bytes[SR_PDU_OFFSET + 28];
+            data->data.length = entry.length - 28 - hashing_context->hash_length * 8;
+
+            buffers[j] = buffer;
+            pdus[j] = &buffer.bytes[SR_PDU_OFFSET];
+            old_sequence_numbers[j] = entry.sequence_number;
         }
 
-        // send packet
-        redundancy_mux_send(connection->redundancy_channel, &data, connection->role);
-        logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA retransmission", "retransmitted packet with old sn=%lu",
-                   (long unsigned int)old_p.sequence_number);
-
-        // increase sn_t
-        connection->sn_t = connection->sn_t + 1;
-
-        // set last message ts
-        reschedule_event(&connection->send_heartbeat_event);
-
-        // free allocated memory of current packet
-        freeRastaByteArray(&packets[i]);
-        freeRastaByteArray(&new_p);
-        freeRastaByteArray(&old_p.data);
-        freeRastaByteArray(&old_p.checksum);
-        freeRastaByteArray(&data.data);
+        rastaModuleSealBytesBatch(packets, pdus, n, hashing_context);
 
-        freeRastaMessageData(&app_messages);
+        for (unsigned int j = 0; j < n; j++) {
+            sr_send_sealed_pdu(connection, &packets[j], buffers[j]);
+            logger_log(connection->logger, LOG_LEVEL_INFO, "RaSTA retransmission", "retransmitted packet with old sn=%lu as sn=%lu",
+                       old_sequence_numbers[j], (long unsigned int)packets[j].sequence_number);
+        }
     }
 
     // close retransmission with heartbeat
@@ -358,7 +348,7 @@ void sr_retransmit_data(rasta_connection *connection) {
 }
 
 unsigned int sr_retransmission_queue_item_count(struct rasta_connection *connection) {
-    return fifo_get_size(connection->fifo_retransmission);
+    return retransmission_store_size(connection->retransmission_store);
 }
 
 unsigned int sr_send_queue_item_count(struct rasta_connection *connection) {
@@ -373,62 +363,231 @@ void sr_listen(struct rasta_handle *h) {
     redundancy_mux_listen_channels(&h->mux);
 }
 
-int sr_send(struct rasta_handle *h, struct rasta_connection *con, struct RastaMessageData app_messages) {
-    if (con == NULL)
+int sr_queue_message(struct rasta_connection *con, struct RastaByteArray *msg) {
+    if (msg->length > sr_max_message_length(con)) {
+        logger_log(con->logger, LOG_LEVEL_ERROR, "RaSTA send", "message is too large for a data packet. Maximum is %u bytes",
+                   sr_max_message_length(con));
         return -1;
+    }
 
-    if (con->current_state == RASTA_CONNECTION_UP) {
-        if (app_messages.count > h->config->sending.max_packet) {
-            // too many application messages
-            logger_log(h->logger, LOG_LEVEL_ERROR, "RaSTA send", "too many application messages to send in one packet. Maximum is %d",
-                       h->config->sending.max_packet);
-            // do nothing and leave method with error code
-            return -1;
-        }
-
-        for (unsigned int i = 0; i < app_messages.count; ++i) {
-            struct RastaByteArray msg;
-            msg = app_messages.data_array[i];
+    if (fifo_full(con->fifo_send)) {
+        // Flush, send queued messages now
+        data_send_event(&con->send_handle, -1);
+    }
 
-            // push into queue
-            struct RastaByteArray *to_fifo = rmalloc(sizeof(struct RastaByteArray));
-            allocateRastaByteArray(to_fifo, msg.length);
-            rmemcpy(to_fifo->bytes, msg.bytes, msg.length);
+    if (!fifo_push(con->fifo_send, msg)) {
+        logger_log(con->logger, LOG_LEVEL_INFO, "RaSTA send", "could not insert message into send queue");
+        return -1;
+    }
 
-            if (fifo_full(con->fifo_send)) {
-                // Flush, send queued messages now
-                data_send_event(&con->send_handle, -1);
-            }
+    // Enable timed sending
+    enable_timed_event(&con->send_handle.send_event);
+    logger_log(con->logger, LOG_LEVEL_DEBUG, "RaSTA send", "data in send queue");
+    return 0;
+}
 
-            if (!fifo_push(con->fifo_send, to_fifo)) {
-                logger_log(h->logger, LOG_LEVEL_INFO, "RaSTA send", "could not insert message into send queue");
-                return -1;
-            } else {
-                // Enable timed sending
-                enable_timed_event(&con->send_handle.send_event);
-                logger_log(h->logger, LOG_LEVEL_DEBUG, "RaSTA send", "data in send queue");
-            }
+void sr_queue_submitted(struct rasta_connection *con) {
+    struct RastaByteArray *msg = con->submit_carry;
+    con->submit_carry = NULL;
+    if (msg == NULL) {
+        msg = mpsc_queue_pop(con->submit_queue);
+    }
+
+    while (msg != NULL) {
+        if (con->current_state != RASTA_CONNECTION_UP || msg->length > sr_max_message_length(con)) {
+            logger_log(con->logger, LOG_LEVEL_INFO, "RaSTA submit", "discarding submitted message");
+            freeRastaByteArray(msg);
+            rfree(msg);
+        } else if (sr_queue_message(con, msg) != 0) {
+            // the send queue stays full until messages are confirmed or a transport channel can send again,
+            // this message and the ones behind it are queued then
+            con->submit_carry = msg;
+            return;
         }
+        msg = mpsc_queue_pop(con->submit_queue);
+    }
+}
+
+/**
+ * checks whether application messages may be sent on a connection and handles the state transitions if not
+ * @return 1 if the connection is up, 0 if it is closed or -1 if the service is not allowed
+ */
+static int sr_send_allowed(struct rasta_handle *h, struct rasta_connection *con) {
+    if (con->current_state == RASTA_CONNECTION_UP) {
+        return 1;
+    }
 
-    } else if (con->current_state == RASTA_CONNECTION_CLOSED || con->current_state == RASTA_CONNECTION_DOWN) {
+    if (con->current_state == RASTA_CONNECTION_CLOSED || con->current_state == RASTA_CONNECTION_DOWN) {
         // nothing to do besides changing state to closed
         con->current_state = RASTA_CONNECTION_CLOSED;
 
         // fire connection state changed event
         fire_on_connection_state_change(sr_create_notification_result(h, con));
-    } else {
-        logger_log(h->logger, LOG_LEVEL_ERROR, "RaSTA send", "service not allowed");
+        return 0;
+    }
 
-        // disconnect and close
-        sendDisconnectionRequest(con, RASTA_DISC_REASON_SERVICENOTALLOWED, 0);
-        con->current_state = RASTA_CONNECTION_CLOSED;
+    logger_log(h->logger, LOG_LEVEL_ERROR, "RaSTA send", "service not allowed");
 
-        // fire connection state changed event
-        fire_on_connection_state_change(sr_create_notification_result(h, con));
+    // disconnect and close
+    sendDisconnectionRequest(con, RASTA_DISC_REASON_SERVICENOTALLOWED, 0);
+    con->current_state = RASTA_CONNECTION_CLOSED;
+
+    // fire connection state changed event
+    fire_on_connection_state_change(sr_create_notification_result(h, con));
+
+    // leave with error code
+    return -1;
+}
 
-        // leave with error code
+int sr_send(struct rasta_handle *h, struct rasta_connection *con, struct RastaMessageData app_messages) {
+    if (con == NULL)
         return -1;
+
+    int allowed = sr_send_allowed(h, con);
+    if (allowed != 1) {
+        return allowed;
     }
+
+    if (app_messages.count > h->config->sending.max_packet) {
+        // too many application messages
+        logger_log(h->logger, LOG_LEVEL_ERROR, "RaSTA send", "too many application messages to send in one packet. Maximum is %d",
+                   h->config->sending.max_packet);
+        // do nothing and leave method with error code
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < app_messages.count; ++i) {
+        struct RastaByteArray msg;
+        msg = app_messages.data_array[i];
+
+        // push into queue
+        struct RastaByteArray *to_fifo = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, sizeof(struct RastaByteArray));
+        allocateRastaByteArray(to_fifo, msg.length);
+        rmemcpy(to_fifo->bytes, msg.bytes, msg.length);
+
+        if (sr_queue_message(con, to_fifo) != 0) {
+            freeRastaByteArray(to_fifo);
+            rfree(to_fifo);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+struct RastaByteArray sr_allocate_pdu_buffer(struct rasta_connection *con, unsigned int sr_length) {
+    struct RastaByteArray buffer;
+    allocateRastaByteArray(&buffer, SR_PDU_OFFSET + sr_length + con->config->redundancy.crc_type.width / 8);
+    return buffer;
+}
+
+/**
+ * sends an SR PDU that has already been sealed, see sr_transmit_pdu
+ */
+static void sr_send_sealed_pdu(struct rasta_connection *con, struct RastaPacket *data, struct RastaByteArray buffer) {
+    // the redundancy layer only writes its header and checksum around the SR PDU, so the buffer can be kept as it is
+    redundancy_mux_send_sealed(con->redundancy_channel, data, buffer.bytes, con->role);
+
+    if (!retransmission_store_push(con->retransmission_store, data->sequence_number, data->timestamp, buffer, SR_PDU_OFFSET, data->length)) {
+        logger_log(con->logger, LOG_LEVEL_INFO, "RaSTA send", "discarding packet because retransmission queue is full");
+        freeRastaByteArray(&buffer);
+    }
+
+    con->sn_t = data->sequence_number + 1;
+
+    // set last message ts
+    reschedule_event(&con->send_heartbeat_event);
+}
+
+void sr_transmit_pdu(struct rasta_connection *con, struct RastaPacket *data, struct RastaByteArray buffer) {
+    rastaModuleSealBytes(data, &buffer.bytes[SR_PDU_OFFSET], &con->redundancy_channel->hashing_context);
+    sr_send_sealed_pdu(con, data, buffer);
+}
+
+unsigned int sr_max_pdu_length(struct rasta_connection *con) {
+    // redundancy header in front of the SR PDU, redundancy checksum behind it
+    return UINT16_MAX - 8 - con->config->redundancy.crc_type.width / 8;
+}
+
+unsigned int sr_max_message_length(struct rasta_connection *con) {
+    // SR header and message length in front of the message, SR safety code behind it
+    return sr_max_pdu_length(con) - 28 - 2 - con->redundancy_channel->hashing_context.hash_length * 8;
+}
+
+unsigned char *sr_reserve_message(struct rasta_connection *con, size_t length) {
+    if (length > sr_max_message_length(con)) {
+        logger_log(con->logger, LOG_LEVEL_ERROR, "RaSTA send", "message is too large for a data packet. Maximum is %u bytes",
+                   sr_max_message_length(con));
+        return NULL;
+    }
+
+    // SR safety code and redundancy checksum behind the message
+    unsigned int sr_length = 28 + 2 + (unsigned int)length + con->redundancy_channel->hashing_context.hash_length * 8;
+    struct RastaByteArray buffer = sr_allocate_pdu_buffer(con, sr_length);
+
+    // remember the reserved length in the SR length field, it is overwritten when the PDU is sealed
+    hostShortTole((uint16_t)length, &buffer.bytes[SR_PDU_OFFSET]);
+    return &buffer.bytes[SR_SEND_HEADROOM];
+}
+
+void sr_release_message(unsigned char *message) {
+    struct RastaByteArray buffer;
+    buffer.bytes = message - SR_SEND_HEADROOM;
+    buffer.length = 0;
+    freeRastaByteArray(&buffer);
+}
+
+int sr_send_reserved(struct rasta_handle *h, struct rasta_connection *con, unsigned char *message, unsigned int length) {
+    unsigned char *bytes = message - SR_SEND_HEADROOM;
+    if (length > leShortToHost(&bytes[SR_PDU_OFFSET])) {
+        logger_log(h->logger, LOG_LEVEL_ERROR, "RaSTA send", "message is larger than the reserved buffer");
+        sr_release_message(message);
+        return -1;
+    }
+
+    int allowed = sr_send_allowed(h, con);
+    if (allowed != 1) {
+        sr_release_message(message);
+        return allowed;
+    }
+
+    // messages queued with sr_send have to go out first to keep the order
+    if (sr_send_queue_item_count(con) > 0) {
+        data_send_event(&con->send_handle, -1);
+    }
+
+    if (sr_send_queue_item_count(con) > 0 || sr_retransmission_queue_item_count(con) >= con->config->retransmission.max_retransmission_queue_size || !redundancy_mux_can_send(con->redundancy_channel)) {
+        // the message has to wait, queue a copy like sr_send does
+        struct RastaByteArray *to_fifo = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, sizeof(struct RastaByteArray));
+        allocateRastaByteArray(to_fifo, length);
+        rmemcpy(to_fifo->bytes, message, length);
+        sr_release_message(message);
+
+        if (sr_queue_message(con, to_fifo) != 0) {
+            freeRastaByteArray(to_fifo);
+            rfree(to_fifo);
+            return -1;
+        }
+        return 0;
+    }
+
+    // build the data PDU around the message
+    struct RastaPacket data;
+    data.type = RASTA_TYPE_DATA;
+    data.receiver_id = con->remote_id;
+    data.sender_id = con->my_id;
+    data.sequence_number = con->sn_t;
+    data.confirmed_sequence_number = con->cs_t;
+    data.timestamp = cur_timestamp();
+    data.confirmed_timestamp = con->ts_r;
+    data.length = (uint16_t)(28 + 2 + length + con->redundancy_channel->hashing_context.hash_length * 8);
+    data.data.bytes = message - 2;
+    data.data.length = 2 + length;
+    hostShortTole((uint16_t)length, data.data.bytes);
+
+    struct RastaByteArray buffer;
+    buffer.bytes = bytes;
+    buffer.length = SR_PDU_OFFSET + data.length + con->config->redundancy.crc_type.width / 8;
+    sr_transmit_pdu(con, &data, buffer);
     return 0;
 }
 
@@ -7,11 +7,43 @@
 #include "../util/event_system.h"
 #include "messages.h"
 
+// position of the SR PDU in the buffers of sent PDUs, leaves room for the redundancy header
+#define SR_PDU_OFFSET 8
+
+// space in front of an application message in a buffer from sr_reserve_message: redundancy header, SR header and message length
+#define SR_SEND_HEADROOM (SR_PDU_OFFSET + 28 + 2)
+
+/**
+ * The data of a received PDU, shared by the application messages it carries
+ */
+struct sr_received_pdu {
+    struct RastaByteArray data;
+    /**
+     * The amount of messages in the receive queue (or lent to the application) that point into the data
+     */
+    unsigned int references;
+};
+
 /**
- * Copy received messages from a RaSTA packet into the receive buffer.
+ * An application message in the receive queue, a view into the data of the PDU that carried it
+ */
+struct sr_received_message {
+    struct RastaByteArray message;
+    struct sr_received_pdu *pdu;
+};
+
+/**
+ * Add the received messages of a RaSTA packet to the receive buffer. The data of the packet is taken over
+ * and shared by the messages, so they are not copied.
  */
 void sr_add_app_messages_to_buffer(struct rasta_connection *con, struct RastaPacket *packet);
 
+/**
+ * Frees a message taken from the receive buffer, the data of its PDU is freed with the last message pointing into it.
+ * @param message the message
+ */
+void sr_release_received_message(struct sr_received_message *message);
+
 /**
  * removes all confirmed messages from the retransmission fifo
  * @param con the connection that is used
@@ -58,10 +90,86 @@ void sr_listen(struct rasta_handle *h);
  */
 int sr_send(struct rasta_handle *h, struct rasta_connection *con, struct RastaMessageData app_messages);
 
+/**
+ * allocates a buffer for an SR PDU at SR_PDU_OFFSET, with room for the redundancy header and checksum around it
+ * @param con the connection the PDU will be sent on
+ * @param sr_length the length of the SR PDU including its safety code
+ * @return the buffer
+ */
+struct RastaByteArray sr_allocate_pdu_buffer(struct rasta_connection *con, unsigned int sr_length);
+
+/**
+ * seals a data PDU whose payload is already in a buffer from sr_allocate_pdu_buffer, sends it
+ * and keeps the buffer for retransmission
+ * @param con the connection to send the PDU on
+ * @param data the header fields of the PDU, the sequence number is taken as the last one sent
+ * @param buffer the buffer, ownership is taken
+ */
+void sr_transmit_pdu(struct rasta_connection *con, struct RastaPacket *data, struct RastaByteArray buffer);
+
+/**
+ * the maximum length of an SR PDU, so that the length of the redundancy PDU around it (redundancy header and
+ * checksum) still fits into its 16 bit length field
+ * @param con the connection the PDU will be sent on
+ * @return the maximum length in bytes
+ */
+unsigned int sr_max_pdu_length(struct rasta_connection *con);
+
+/**
+ * the maximum length of a single application message, so that a data PDU carrying only this message
+ * does not exceed sr_max_pdu_length
+ * @param con the connection the message will be sent on
+ * @return the maximum length in bytes
+ */
+unsigned int sr_max_message_length(struct rasta_connection *con);
+
+/**
+ * allocates a buffer for a single application message with room for the headers and checksums around it
+ * @param con the connection the message will be sent on
+ * @param length the maximum length of the message
+ * @return pointer to where the message has to be written, SR_SEND_HEADROOM bytes into the buffer,
+ *         or NULL if the length is larger than sr_max_message_length
+ */
+unsigned char *sr_reserve_message(struct rasta_connection *con, size_t length);
+
+/**
+ * frees a buffer from sr_reserve_message without sending it
+ * @param message the pointer returned by sr_reserve_message
+ */
+void sr_release_message(unsigned char *message);
+
+/**
+ * sends an application message that was written into a buffer from sr_reserve_message as its own data PDU,
+ * the headers and checksums are written around the message in place. If messages are still waiting in the
+ * send queue, the message is queued behind them instead.
+ * @param h the handle of the local RaSTA instance
+ * @param con the connection to send the message on
+ * @param message the pointer returned by sr_reserve_message, always released
+ * @param length the length of the message
+ * @return 0 on success, -1 on error
+ */
+int sr_send_reserved(struct rasta_handle *h, struct rasta_connection *con, unsigned char *message, unsigned int length);
+
+/**
+ * adds a single application message to the send queue of a connection that is up
+ * @param con the connection to send the message on
+ * @param msg the message, ownership is only taken on success
+ * @return 0 on success, -1 if the send queue is full or the message is larger than sr_max_message_length
+ */
+int sr_queue_message(struct rasta_connection *con, struct RastaByteArray *msg);
+
+/**
+ * moves messages submitted from other threads to the send queue of a connection, in the order they were submitted.
+ * Stops at the first message that does not fit, it is kept and queued first on the next call.
+ * Messages submitted while the connection is not up are discarded.
+ * @param con the connection whose submitted messages are queued
+ */
+void sr_queue_submitted(struct rasta_connection *con);
+
 /**
  * Handle a received packet on the safety/retransmission level and check validity
  * @param con the connection on which the packet was received
- * @param receivedPacket the packet that was received
+ * @param receivedPacket the packet that was received, its data is taken over. The checksum stays with the caller
  */
 int sr_receive(rasta_connection *con, struct RastaPacket *receivedPacket);
 
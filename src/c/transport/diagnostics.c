@@ -92,7 +92,7 @@ void run_channel_diagnostics(rasta_redundancy_channel *current, unsigned int tra
         // increase n_missed by amount of messages that are not received
 
         // amount of missed packets
-        int missed_count = current->diagnostics_packet_buffer.count -
+        int missed_count = current->diagnostics_window.count -
                            current->transport_channels[transport_channel_index].diagnostics_data.received_packets;
 
         // increase n_missed
@@ -114,6 +114,6 @@ void run_channel_diagnostics(rasta_redundancy_channel *current, unsigned int tra
         current->transport_channels[transport_channel_index].diagnostics_data.t_drift2 = 0;
         current->transport_channels[transport_channel_index].diagnostics_data.start_time = cur_timestamp();
 
-        deferqueue_clear(&current->diagnostics_packet_buffer);
+        diagnostics_window_clear(&current->diagnostics_window);
     }
 }
@@ -138,6 +138,30 @@ void udp_send_sockaddr(rasta_transport_channel *transport_channel, unsigned char
     wolfssl_send_dtls(transport_channel, message, message_len, &receiver);
 }
 
+bool udp_receive_pending(rasta_transport_socket *transport_socket) {
+    // wolfSSL reads one record per call
+    UNUSED(transport_socket);
+    return false;
+}
+
+void udp_enable_offload(rasta_transport_socket *transport_socket) {
+    // DTLS records are written by wolfSSL one at a time
+    UNUSED(transport_socket);
+}
+
+bool udp_offload_enabled(rasta_transport_socket *transport_socket) {
+    UNUSED(transport_socket);
+    return false;
+}
+
+void udp_cork(rasta_transport_socket *transport_socket) {
+    UNUSED(transport_socket);
+}
+
+void udp_flush(rasta_transport_socket *transport_socket) {
+    UNUSED(transport_socket);
+}
+
 bool is_dtls_conn_ready(rasta_transport_socket *socket) {
     return socket != NULL && socket->tls_state == RASTA_TLS_CONNECTION_READY;
 }
@@ -2,6 +2,7 @@
 
 #include <inttypes.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include <rasta/rasta.h>
 
@@ -56,18 +57,14 @@ int channel_accept_event(void *carry_data, int _fd) {
     return 0;
 }
 
-int channel_receive_event(void *carry_data, int fd) {
-    UNUSED(fd);
-
-    struct receive_event_data *data = carry_data;
+static int channel_receive_pdu(struct receive_event_data *data) {
     rasta_connection *connection = data->connection;
 
-    unsigned char buffer[MAX_DEFER_QUEUE_MSG_SIZE] = {0};
+    unsigned char receive_buffer[MAX_DEFER_QUEUE_MSG_SIZE] = {0};
+    unsigned char *buffer = receive_buffer;
     struct sockaddr_in sender = {0};
 
-    bool is_dtls_conn_ready_result = is_dtls_conn_ready(data->socket);
-
-    ssize_t len = receive_callback(data, buffer, &sender);
+    ssize_t len = receive_callback(data, &buffer, &sender);
 
     char str[INET_ADDRSTRLEN];
     inet_ntop(AF_INET, &sender.sin_addr, str, INET_ADDRSTRLEN);
@@ -88,6 +85,7 @@ int channel_receive_event(void *carry_data, int fd) {
 
         connection = data->h->rasta_connection;
         transport_channel->file_descriptor = data->socket->file_descriptor;
+        transport_channel->associated_socket = data->socket;
 
         // We can regard UDP channels as 'always connected' (no re-dial possible)
         transport_channel->connected = true;
@@ -97,8 +95,7 @@ int channel_receive_event(void *carry_data, int fd) {
 
     logger_log(connection->logger, LOG_LEVEL_DEBUG, "RaSTA RedMux receive", "Channel %d calling receive", transport_channel->id);
 
-    // when performing DTLS accept, len = 0 doesn't signal a broken connection
-    if (len <= 0 && !is_dtls_conn_ready_result) {
+    if (len < 0) {
         // Connection is broken
         transport_channel->connected = false;
 
@@ -119,7 +116,7 @@ int channel_receive_event(void *carry_data, int fd) {
         return 0;
     }
 
-    if (receive_packet(connection->redundancy_channel->mux, transport_channel, buffer, len)) {
+    if (len > 0 && receive_packet(connection->redundancy_channel->mux, transport_channel, buffer, len)) {
         // Deliver messages to the upper layer
         return red_f_deliverDeferQueue(connection, connection->redundancy_channel);
     }
@@ -129,6 +126,38 @@ int channel_receive_event(void *carry_data, int fd) {
     return 0;
 }
 
+int channel_receive_event(void *carry_data, int fd) {
+    UNUSED(fd);
+
+    struct receive_event_data *data = carry_data;
+    redundancy_mux *mux = &data->h->mux;
+    int result = 0;
+
+    // the event also fires when a TCP channel with queued data becomes writable
+    if (data->channel != NULL) {
+        bool could_send = transport_can_send(data->channel);
+        transport_send_queued(data->channel);
+        if (!could_send && transport_can_send(data->channel) && data->connection != NULL) {
+            // send the application messages that have been held back
+            if (sr_send_queue_item_count(data->connection) > 0) {
+                data_send_event(&data->connection->send_handle, -1);
+            }
+            if (data->connection->submit_carry != NULL) {
+                sr_queue_submitted(data->connection);
+            }
+        }
+    }
+
+    // the transport may have read several PDUs at once, the responses to all of them are sent together
+    redundancy_mux_cork(mux);
+    do {
+        result |= channel_receive_pdu(data);
+    } while (transport_receive_pending(data));
+    redundancy_mux_flush(mux);
+
+    return result;
+}
+
 int event_connection_expired(void *carry_data, int fd) {
     UNUSED(fd);
 
@@ -201,7 +230,8 @@ int data_send_event(void *carry_data, int fd) {
     unsigned int retransmission_backlog_size = sr_retransmission_queue_item_count(con);
     // Because of this condition, this method does not reliably free up space in the send queue.
     // However, we need to pass on backpressure to the caller...
-    if (retransmission_backlog_size < con->config->retransmission.max_retransmission_queue_size) {
+    // The same holds if no transport channel accepts more data, the messages wait until one can send again.
+    if (retransmission_backlog_size < con->config->retransmission.max_retransmission_queue_size && redundancy_mux_can_send(con->redundancy_channel)) {
         unsigned int retransmission_available_size = con->config->retransmission.max_retransmission_queue_size - retransmission_backlog_size;
         unsigned int send_backlog_size = sr_send_queue_item_count(con);
 
@@ -214,57 +244,58 @@ int data_send_event(void *carry_data, int fd) {
             logger_log(h->logger, LOG_LEVEL_DEBUG, "RaSTA send handler", "Messages waiting to be sent: %d",
                        sr_send_queue_item_count(con));
 
-            struct RastaMessageData app_messages;
-            struct RastaByteArray msg;
-
             if (send_backlog_size >= h->config->max_packet) {
                 send_backlog_size = h->config->max_packet;
             }
-            allocateRastaMessageData(&app_messages, send_backlog_size);
 
             logger_log(h->logger, LOG_LEVEL_DEBUG, "RaSTA send handler",
                        "Sending %d application messages from queue",
                        send_backlog_size);
 
+            // the PDU has to stay within sr_max_pdu_length, the remaining messages go into the next PDU
+            unsigned int message_length = 0;
+            unsigned int max_message_length = sr_max_pdu_length(con) - 28 - h->hashing_context->hash_length * 8;
             for (unsigned int i = 0; i < send_backlog_size; i++) {
+                struct RastaByteArray *elem = fifo_get(con->fifo_send, i);
+                if (i > 0 && message_length + 2 + elem->length > max_message_length) {
+                    send_backlog_size = i;
+                    break;
+                }
+                message_length += 2 + elem->length;
+            }
 
-                struct RastaByteArray *elem;
-                elem = fifo_pop(con->fifo_send);
+            struct RastaPacket data;
+            data.length = (uint16_t)(28 + message_length + h->hashing_context->hash_length * 8);
+            data.type = RASTA_TYPE_DATA;
+            data.receiver_id = con->remote_id;
+            data.sender_id = con->my_id;
+            data.sequence_number = con->sn_t;
+            data.confirmed_sequence_number = con->cs_t;
+            data.timestamp = cur_timestamp();
+            data.confirmed_timestamp = con->ts_r;
+
+            // the messages are written once, directly into the buffer that is sent and kept for retransmission
+            struct RastaByteArray buffer = sr_allocate_pdu_buffer(con, data.length);
+            data.data.bytes = &buffer.bytes[SR_PDU_OFFSET + 28];
+            data.data.length = message_length;
+
+            unsigned int position = 0;
+            for (unsigned int i = 0; i < send_backlog_size; i++) {
+                struct RastaByteArray *elem = fifo_pop(con->fifo_send);
                 logger_log(h->logger, LOG_LEVEL_DEBUG, "RaSTA send handler",
                            "Adding application message to data packet");
 
-                allocateRastaByteArray(&msg, elem->length);
-                msg.bytes = rmemcpy(msg.bytes, elem->bytes, elem->length);
+                hostShortTole((uint16_t)elem->length, &data.data.bytes[position]);
+                rmemcpy(&data.data.bytes[position + 2], elem->bytes, elem->length);
+                position += 2 + elem->length;
+
                 freeRastaByteArray(elem);
                 rfree(elem);
-                app_messages.data_array[i] = msg;
-            }
-
-            struct RastaPacket data = createDataMessage(con->remote_id, con->my_id, con->sn_t,
-                                                        con->cs_t, cur_timestamp(), con->ts_r,
-                                                        app_messages, h->hashing_context);
-
-            struct RastaByteArray packet = rastaModuleToBytes(&data, h->hashing_context);
-
-            struct RastaByteArray *to_fifo = rmalloc(sizeof(struct RastaByteArray));
-            allocateRastaByteArray(to_fifo, packet.length);
-            rmemcpy(to_fifo->bytes, packet.bytes, packet.length);
-            if (!fifo_push(con->fifo_retransmission, to_fifo)) {
-                logger_log(h->logger, LOG_LEVEL_INFO, "RaSTA send handler", "discarding packet because retransmission queue is full");
             }
 
-            redundancy_mux_send(con->redundancy_channel, &data, con->role);
+            sr_transmit_pdu(con, &data, buffer);
 
             logger_log(h->logger, LOG_LEVEL_DEBUG, "RaSTA send handler", "Sent data packet from queue");
-
-            con->sn_t = data.sequence_number + 1;
-
-            // set last message ts
-            reschedule_event(&con->send_heartbeat_event);
-
-            freeRastaMessageData(&app_messages);
-            freeRastaByteArray(&packet);
-            freeRastaByteArray(&data.data);
         }
     }
 
@@ -276,6 +307,20 @@ int data_send_event(void *carry_data, int fd) {
     return 0;
 }
 
+int data_submit_event(void *carry_data, int fd) {
+    rasta_connection *con = carry_data;
+
+    // acknowledge the doorbell before draining, so messages submitted during the drain ring it again
+    uint64_t count;
+    ssize_t ignored = read(fd, &count, sizeof(count));
+    (void)ignored;
+    atomic_store(&con->submit_pending, false);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    sr_queue_submitted(con);
+    return 0;
+}
+
 int send_timed_key_exchange(void *arg, int fd) {
     UNUSED(fd);
 
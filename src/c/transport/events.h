@@ -24,6 +24,7 @@ int channel_accept_event(void *carry_data, int fd);
 int channel_receive_event(void *carry_data, int fd);
 
 int data_send_event(void *carry_data, int fd);
+int data_submit_event(void *carry_data, int fd);
 int heartbeat_send_event(void *carry_data, int fd);
 int event_connection_expired(void *carry_data, int fd);
 
@@ -188,8 +188,17 @@ void wolfssl_send_dtls(rasta_transport_channel *transport_channel, unsigned char
     wolfssl_send(transport_channel->ssl, message, message_len);
 }
 
-void wolfssl_send_tls(WOLFSSL *ssl, unsigned char *message, size_t message_len) {
-    wolfssl_send(ssl, message, message_len);
+ssize_t wolfssl_send_tls(WOLFSSL *ssl, unsigned char *message, size_t message_len) {
+    int sent = wolfSSL_write(ssl, message, (int)message_len);
+    if (sent <= 0) {
+        int writeErr = wolfSSL_get_error(ssl, sent);
+        if (writeErr == SSL_ERROR_WANT_WRITE || writeErr == SSL_ERROR_WANT_READ) {
+            return 0;
+        }
+        fprintf(stderr, "WolfSSL write error: %s.\n", wolfSSL_ERR_reason_error_string(writeErr));
+        return -1;
+    }
+    return sent;
 }
 
 ssize_t wolfssl_receive_tls(WOLFSSL *ssl, unsigned char *received_message, size_t max_buffer_len) {
@@ -206,6 +215,11 @@ ssize_t wolfssl_receive_tls(WOLFSSL *ssl, unsigned char *received_message, size_
         received_total += receive_len;
     } while (receive_len > 0 && max_buffer_len);
 
+    if (receive_len == 0 && received_total == 0) {
+        // the peer has closed the session
+        return -1;
+    }
+
     if (receive_len < 0) {
         int readErr = wolfSSL_get_error(ssl, 0);
         if (readErr == SOCKET_PEER_CLOSED_E) {
@@ -30,7 +30,15 @@ void wolfssl_start_client(WOLFSSL_CTX **ctx, const rasta_config_tls *tls_config,
 
 void wolfssl_send(WOLFSSL *ssl, unsigned char *message, size_t message_len);
 
-void wolfssl_send_tls(WOLFSSL *ssl, unsigned char *message, size_t message_len);
+/**
+ * Writes a message on a non-blocking TLS session.
+ * @param ssl the wolfssl session object
+ * @param message the message to write
+ * @param message_len the length of the @p message
+ * @return the amount of written bytes, 0 if the socket does not accept data right now or -1 if the session is broken.
+ * After 0, wolfSSL keeps the encrypted record and the write has to be repeated with the same bytes.
+ */
+ssize_t wolfssl_send_tls(WOLFSSL *ssl, unsigned char *message, size_t message_len);
 
 void wolfssl_send_dtls(rasta_transport_channel *transport_channel, unsigned char *message, size_t message_len, struct sockaddr_in *receiver);
 
@@ -1,5 +1,6 @@
 #include <arpa/inet.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -19,6 +20,17 @@ void tcp_listen(rasta_transport_socket *transport_socket) {
     }
 }
 
+/**
+ * Makes the socket of a channel non-blocking, so a stalled connection cannot hold up the event loop
+ */
+static void tcp_set_nonblocking(int file_descriptor) {
+    int socket_flags = fcntl(file_descriptor, F_GETFL, 0);
+    if (socket_flags < 0 || fcntl(file_descriptor, F_SETFL, socket_flags | O_NONBLOCK) != 0) {
+        perror("Error setting socket non-blocking");
+        abort();
+    }
+}
+
 int tcp_accept(rasta_transport_socket *transport_socket) {
     struct sockaddr_in empty_sockaddr_in;
     socklen_t sender_len = sizeof(empty_sockaddr_in);
@@ -28,6 +40,7 @@ int tcp_accept(rasta_transport_socket *transport_socket) {
         abort();
     }
 
+    tcp_set_nonblocking(socket);
     return socket;
 }
 
@@ -36,20 +49,38 @@ ssize_t tcp_receive(rasta_transport_channel *transport_channel, unsigned char *r
     struct sockaddr_in empty_sockaddr_in;
     socklen_t sender_len = sizeof(empty_sockaddr_in);
 
-    // wait for incoming data
     if ((recv_len = recvfrom(transport_channel->file_descriptor, received_message, max_buffer_len, 0, (struct sockaddr *)sender, &sender_len)) < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            // nothing to read yet, e.g. the event fired because the socket became writable
+            return 0;
+        }
         perror("an error occured while trying to receive data");
         return -1;
     }
 
-    return (size_t)recv_len;
+    if (recv_len == 0) {
+        // the peer has closed the connection
+        return -1;
+    }
+
+    return recv_len;
 }
 
-void tcp_send(rasta_transport_channel *transport_channel, unsigned char *message, size_t message_len) {
-    if (send(transport_channel->file_descriptor, message, message_len, 0) < 0) {
+ssize_t tcp_send(rasta_transport_channel *transport_channel, const struct iovec *iov, int iov_count) {
+    // sendmsg instead of writev, so a closed connection does not raise SIGPIPE
+    struct msghdr message = {0};
+    message.msg_iov = (struct iovec *)iov;
+    message.msg_iovlen = iov_count;
+
+    ssize_t sent = sendmsg(transport_channel->file_descriptor, &message, MSG_NOSIGNAL);
+    if (sent < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0;
+        }
         perror("failed to send data");
-        abort();
+        return -1;
     }
+    return sent;
 }
 
 void tcp_close(rasta_transport_channel *transport_channel) {
@@ -74,6 +105,7 @@ int tcp_connect(rasta_transport_channel *channel) {
         return 1;
     }
 
+    tcp_set_nonblocking(channel->file_descriptor);
     channel->connected = true;
     return 0;
 }
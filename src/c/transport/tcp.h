@@ -1,5 +1,6 @@
 #include <netinet/in.h>
 #include <stdint.h>
+#include <sys/uio.h>
 
 #include <rasta/config.h>
 
@@ -16,12 +17,12 @@ void tcp_listen(rasta_transport_socket *transport_socket);
 
 /**
  * Receive data on the given @p file descriptor and store it in the given buffer.
- * This function will block until data is received!
+ * The socket is non-blocking, so this function returns right away if no data is available.
  * @param ssl the wolfssl session object
  * @param received_message a buffer where the received data will be written too. Has to be at least \p max_buffer_len long
  * @param max_buffer_len the amount of data which will be received in bytes
  * @param sender information about the sender of the data will be stored here
- * @return the amount of received bytes
+ * @return the amount of received bytes, 0 if no data is available right now or -1 if the connection is closed or broken
  */
 ssize_t tcp_receive(rasta_transport_channel *transport_channel, unsigned char *received_message, size_t max_buffer_len, struct sockaddr_in *sender);
 
@@ -42,12 +43,13 @@ int tcp_accept(rasta_transport_socket *transport_socket);
 int tcp_connect(rasta_transport_channel *channel);
 
 /**
- * Sends a message via the given file descriptor to a @p host and @p port
- * @param file_descriptor the file descriptor which is used to send the message
- * @param message the message that which will be send
- * @param message_len the length of the @p message
+ * Writes as much of the given data as the socket accepts without blocking, like writev
+ * @param transport_channel the channel which is used to send the data
+ * @param iov the areas of data to send
+ * @param iov_count the amount of areas in @p iov
+ * @return the amount of written bytes, 0 if the socket does not accept data right now or -1 if the connection is broken
  */
-void tcp_send(rasta_transport_channel *transport_channel, unsigned char *message, size_t message_len);
+ssize_t tcp_send(rasta_transport_channel *transport_channel, const struct iovec *iov, int iov_count);
 
 /**
  * Closes the tcp socket
@@ -3,10 +3,39 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../logging.h"
 #include "../rastahandle.h"
 #include "../util/rmemory.h"
 #include "bsd_utils.h"
 
+// amount of bytes that is read from the stream at least, the reassembly buffer of a channel grows to fit it
+#define TCP_RECEIVE_SIZE 65536
+
+// the length prefix, reserved field and sequence number of a redundancy layer PDU
+#define TCP_MIN_PDU_LENGTH 8
+
+// bytes that are queued for a channel whose socket does not accept more data, further PDUs are dropped for that channel
+#define TCP_SEND_BUFFER_SIZE 262144
+
+// application data is held back while more bytes are queued, the rest of the buffer is left for control PDUs
+#define TCP_SEND_BUFFER_HIGH_WATER (TCP_SEND_BUFFER_SIZE / 2)
+
+/**
+ * The receive event of a channel also writes its queued data, so it only watches for writability while there is some
+ */
+static void tcp_watch_writable(rasta_transport_channel *channel) {
+    set_fd_event_options(&channel->receive_event, channel->send_buffer.size > 0 ? EV_READABLE | EV_WRITABLE : EV_READABLE);
+}
+
+/**
+ * Discards the buffered data of both directions, e.g. when the stream has been closed
+ */
+static void tcp_clear_buffers(rasta_transport_channel *channel) {
+    reassembly_buffer_clear(&channel->receive_buffer);
+    send_buffer_clear(&channel->send_buffer);
+    tcp_watch_writable(channel);
+}
+
 void transport_create_socket(struct rasta_handle *h, rasta_transport_socket *socket, int id, const rasta_config_tls *tls_config) {
     // init socket
     socket->id = id;
@@ -58,6 +87,7 @@ int transport_connect(rasta_transport_socket *socket, rasta_transport_channel *c
 
     channel->receive_event.fd = channel->file_descriptor;
     channel->receive_event_data.channel = channel;
+    tcp_clear_buffers(channel);
 
     enable_fd_event(&channel->receive_event);
 
@@ -90,10 +120,16 @@ void transport_close_channel(rasta_transport_channel *channel) {
         channel->file_descriptor = -1;
         channel->connected = false;
     }
+    tcp_clear_buffers(channel);
 
     disable_fd_event(&channel->receive_event);
 }
 
+void transport_free_channel(rasta_transport_channel *channel) {
+    reassembly_buffer_destroy(&channel->receive_buffer);
+    send_buffer_destroy(&channel->send_buffer);
+}
+
 void transport_close_socket(rasta_transport_socket *socket) {
     if (socket->file_descriptor != -1) {
         bsd_close(socket->file_descriptor);
@@ -104,14 +140,100 @@ void transport_close_socket(rasta_transport_socket *socket) {
 }
 
 void send_callback(struct RastaByteArray data_to_send, rasta_transport_channel *channel) {
-    tcp_send(channel, data_to_send.bytes, data_to_send.length);
+    send_buffer_t *queue = &channel->send_buffer;
+    unsigned int sent = 0;
+
+    if (queue->size == 0) {
+        // nothing is waiting, so the PDU is written right away
+        struct iovec iov = {.iov_base = data_to_send.bytes, .iov_len = data_to_send.length};
+        ssize_t result = tcp_send(channel, &iov, 1);
+        if (result < 0) {
+            // the connection is broken, the receive event notices that and reports the closed channel
+            return;
+        }
+        sent = (unsigned int)result;
+        if (sent == data_to_send.length) {
+            return;
+        }
+    }
+
+    if (queue->capacity == 0) {
+        send_buffer_init(queue, TCP_SEND_BUFFER_SIZE);
+    }
+
+    // only whole PDUs are dropped, so the stream stays intact
+    if (!send_buffer_push(queue, &data_to_send.bytes[sent], data_to_send.length - sent)) {
+        logger_log(channel->receive_event_data.h->logger, LOG_LEVEL_INFO, "RaSTA TCP", "channel %d: discarding PDU because the send queue is full", channel->id);
+        return;
+    }
+    tcp_watch_writable(channel);
 }
 
-ssize_t receive_callback(struct receive_event_data *data, unsigned char *buffer, struct sockaddr_in *sender) {
-    // TODO: exchange MAX_DEFER_QUEUE_MSG_SIZE by something depending on send_max (i.e. the receive buffer size)
-    // search for connected_recv_buffer_size
-    // TODO: Manage possible remaining data in the receive buffer on next call to rasta_recv
-    return tcp_receive(data->channel, buffer, MAX_DEFER_QUEUE_MSG_SIZE, sender);
+void transport_send_queued(rasta_transport_channel *channel) {
+    send_buffer_t *queue = &channel->send_buffer;
+    struct iovec iov[2];
+    int iov_count;
+
+    while ((iov_count = send_buffer_iov(queue, iov)) > 0) {
+        ssize_t sent = tcp_send(channel, iov, iov_count);
+        if (sent < 0) {
+            // the connection is broken, the queued data cannot be delivered anymore
+            send_buffer_clear(queue);
+            break;
+        }
+        if (sent == 0) {
+            break;
+        }
+        send_buffer_consume(queue, (unsigned int)sent);
+    }
+
+    tcp_watch_writable(channel);
+}
+
+bool transport_can_send(rasta_transport_channel *channel) {
+    return channel->send_buffer.size < TCP_SEND_BUFFER_HIGH_WATER;
+}
+
+ssize_t receive_callback(struct receive_event_data *data, unsigned char **buffer, struct sockaddr_in *sender) {
+    rasta_transport_channel *channel = data->channel;
+    reassembly_buffer_t *stream = &channel->receive_buffer;
+
+    // PDUs are split across reads at arbitrary positions, only complete ones are handed out
+    unsigned int missing = reassembly_buffer_missing(stream);
+    if (missing > 0) {
+        unsigned int length;
+        unsigned char *area = reassembly_buffer_write_area(stream, missing > TCP_RECEIVE_SIZE ? missing : TCP_RECEIVE_SIZE, &length);
+
+        ssize_t recv_len = tcp_receive(channel, area, length, sender);
+        if (recv_len < 0) {
+            tcp_clear_buffers(channel);
+            return -1;
+        }
+        reassembly_buffer_commit(stream, (unsigned int)recv_len);
+    }
+
+    int pdu_len = reassembly_buffer_next(stream, TCP_MIN_PDU_LENGTH, buffer);
+    if (pdu_len < 0) {
+        // the stream is out of sync, there is no way to find the start of the next PDU
+        tcp_clear_buffers(channel);
+        return -1;
+    }
+    return pdu_len;
+}
+
+bool transport_receive_pending(struct receive_event_data *data) {
+    // a single read may contain several PDUs, they are handed out one by one so that the defer queue
+    // of the redundancy layer is drained in between
+    rasta_transport_channel *channel = data->channel;
+    return channel != NULL && channel->connected && reassembly_buffer_missing(&channel->receive_buffer) == 0;
+}
+
+void transport_cork(rasta_transport_socket *socket) {
+    UNUSED(socket);
+}
+
+void transport_flush(rasta_transport_socket *socket) {
+    UNUSED(socket);
 }
 
 bool is_dtls_conn_ready(rasta_transport_socket *socket) {
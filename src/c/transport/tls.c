@@ -211,8 +211,11 @@ ssize_t tcp_receive(rasta_transport_channel *transport_channel, unsigned char *r
     return wolfssl_receive_tls(transport_channel->ssl, received_message, max_buffer_len);
 }
 
-void tcp_send(rasta_transport_channel *transport_channel, unsigned char *message, size_t message_len) {
-    wolfssl_send_tls(transport_channel->ssl, message, message_len);
+ssize_t tcp_send(rasta_transport_channel *transport_channel, const struct iovec *iov, int iov_count) {
+    UNUSED(iov_count);
+    // wolfSSL encrypts one buffer at a time, the second area is written by the next call.
+    // A write that returned 0 is repeated with the same bytes, as the first area only grows while it is pending.
+    return wolfssl_send_tls(transport_channel->ssl, iov[0].iov_base, iov[0].iov_len);
 }
 
 void tcp_close(rasta_transport_channel *transport_channel) {
@@ -6,6 +6,8 @@
 #include <rasta/config.h>
 
 #include "../util/rastautil.h"
+#include "../util/reassembly_buffer.h"
+#include "../util/send_buffer.h"
 #include "diagnostics.h"
 #include "events.h"
 
@@ -68,6 +70,18 @@ typedef struct rasta_transport_channel {
     void (*send_callback)(struct RastaByteArray data_to_send, struct rasta_transport_channel *channel);
 
     rasta_transport_socket *associated_socket;
+
+#ifdef USE_TCP
+    /**
+     * bytes of the stream that do not form a complete PDU yet
+     */
+    reassembly_buffer_t receive_buffer;
+
+    /**
+     * bytes that the socket did not accept yet, written when the socket becomes writable
+     */
+    send_buffer_t send_buffer;
+#endif
 } rasta_transport_channel;
 
 typedef struct rasta_transport_socket {
@@ -92,10 +106,59 @@ typedef struct rasta_transport_socket {
     enum rasta_tls_connection_state tls_state;
 #endif
 
+#ifdef USE_UDP
+    /**
+     * datagrams that are received or sent together, allocated on first use
+     */
+    struct udp_batch *batch;
+#endif
+
 } rasta_transport_socket;
 
 void send_callback(struct RastaByteArray data_to_send, rasta_transport_channel *channel);
-ssize_t receive_callback(struct receive_event_data *data, unsigned char *buffer, struct sockaddr_in *sender);
+
+/**
+ * Receives PDUs from the transport.
+ * @param data the data of the receive event
+ * @param buffer points to a buffer of MAX_DEFER_QUEUE_MSG_SIZE bytes. Transports that buffer the received data
+ * themselves point it to the received PDUs instead, these stay valid until the next call.
+ * @param sender the address of the sender is stored here
+ * @return the total length of the received PDUs, 0 if there is no complete PDU yet, or -1 if the transport is broken
+ */
+ssize_t receive_callback(struct receive_event_data *data, unsigned char **buffer, struct sockaddr_in *sender);
+
+/**
+ * Checks if data that has already been read from the transport is waiting to be handed out by receive_callback.
+ * @param data the data of the receive event
+ * @return true if the next call to receive_callback returns without blocking
+ */
+bool transport_receive_pending(struct receive_event_data *data);
+
+/**
+ * Writes the data that is queued for the channel as far as the socket accepts it without blocking.
+ * @param channel the channel
+ */
+void transport_send_queued(rasta_transport_channel *channel);
+
+/**
+ * Checks if the channel accepts more data without queueing too much of it, used to hold back application data.
+ * PDUs that are sent anyway are queued up to a hard limit and dropped for this channel beyond it.
+ * @param channel the channel
+ * @return true if data can be sent on the channel
+ */
+bool transport_can_send(rasta_transport_channel *channel);
+
+/**
+ * Queues the data that is sent via the given socket until transport_flush is called, if the transport supports it.
+ * @param socket the socket
+ */
+void transport_cork(rasta_transport_socket *socket);
+
+/**
+ * Sends the data that has been queued since transport_cork.
+ * @param socket the socket
+ */
+void transport_flush(rasta_transport_socket *socket);
 
 void transport_init(struct rasta_handle *h, rasta_transport_channel *channel, unsigned id, const char *host, uint16_t port, const rasta_config_tls *tls_config);
 void transport_create_socket(struct rasta_handle *h, rasta_transport_socket *socket, int id, const rasta_config_tls *tls_config);
@@ -106,6 +169,7 @@ int transport_connect(rasta_transport_socket *socket, rasta_transport_channel *c
 int transport_redial(rasta_transport_channel *channel);
 void transport_close_channel(rasta_transport_channel *channel);
 void transport_close_socket(rasta_transport_socket *socket);
+void transport_free_channel(rasta_transport_channel *channel);
 
 bool is_dtls_conn_ready(rasta_transport_socket *socket);
 
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include "udp.h"
 
 #include <arpa/inet.h>
@@ -6,40 +7,374 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h> //memset
+#include <netinet/udp.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
+#include "../redundancy/rastaredundancy.h"
 #include "../util/rmemory.h"
 #include "bsd_utils.h"
 #include "transport.h"
 
+// size of the datagram slots in a batch
+#define UDP_BATCH_SLOT_SIZE MAX_DEFER_QUEUE_MSG_SIZE
+
+// large enough for the datagrams the kernel coalesces with UDP_GRO
+#define UDP_RECEIVE_BUFFER_SIZE 65536
+
+// the kernel does not coalesce more datagrams than this
+#define UDP_MAX_SEGMENTS 64
+
+/**
+ * Datagrams received with one system call that have not been handed out yet,
+ * and datagrams that are queued to be sent with one system call
+ */
+struct udp_batch {
+    /**
+     * the amount of datagrams received by the last receive call
+     */
+    unsigned int received;
+    /**
+     * the index of the next received datagram to hand out
+     */
+    unsigned int next;
+    size_t receive_offset[UDP_MAX_SEGMENTS];
+    size_t receive_length[UDP_MAX_SEGMENTS];
+    struct sockaddr_in receive_address[UDP_MAX_SEGMENTS];
+    unsigned char receive_buffer[UDP_RECEIVE_BUFFER_SIZE];
+
+    /**
+     * true if equal-sized datagrams to the same receiver are sent as one buffer that is segmented by the kernel (UDP_SEGMENT)
+     */
+    bool gso;
+    /**
+     * true if the kernel may coalesce received datagrams of the same sender (UDP_GRO)
+     */
+    bool gro;
+
+    /**
+     * while corked, datagrams are queued until udp_flush is called or the batch is full
+     */
+    bool corked;
+    /**
+     * the amount of queued datagrams
+     */
+    unsigned int queued;
+    size_t send_length[UDP_BATCH_SIZE];
+    struct sockaddr_in send_address[UDP_BATCH_SIZE];
+    unsigned char send_buffer[UDP_BATCH_SIZE][UDP_BATCH_SLOT_SIZE];
+};
+
+static struct udp_batch *udp_get_batch(rasta_transport_socket *transport_socket) {
+    if (transport_socket->batch == NULL) {
+        transport_socket->batch = rmalloc(sizeof(struct udp_batch));
+        rmemset(transport_socket->batch, 0, sizeof(struct udp_batch));
+    }
+    return transport_socket->batch;
+}
+
+/**
+ * Blocks until at least one datagram is available and reads as many datagrams as are waiting, up to UDP_BATCH_SIZE
+ */
+static void udp_receive_batch(int file_descriptor, struct udp_batch *batch) {
+#ifdef USE_MMSG
+    struct mmsghdr msgs[UDP_BATCH_SIZE];
+    struct iovec iov[UDP_BATCH_SIZE];
+    rmemset(msgs, 0, sizeof(msgs));
+    for (unsigned int i = 0; i < UDP_BATCH_SIZE; i++) {
+        batch->receive_offset[i] = i * UDP_BATCH_SLOT_SIZE;
+        iov[i].iov_base = &batch->receive_buffer[batch->receive_offset[i]];
+        iov[i].iov_len = UDP_BATCH_SLOT_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &batch->receive_address[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+
+    // block for the first datagram only, then take what is already queued on the socket
+    int count = recvmmsg(file_descriptor, msgs, UDP_BATCH_SIZE, MSG_WAITFORONE, NULL);
+    if (count == -1) {
+        perror("an error occured while trying to receive data");
+        abort();
+    }
+
+    for (int i = 0; i < count; i++) {
+        batch->receive_length[i] = msgs[i].msg_len;
+    }
+    batch->received = (unsigned int)count;
+#else
+    socklen_t sender_len = sizeof(struct sockaddr_in);
+    ssize_t recv_len = recvfrom(file_descriptor, batch->receive_buffer, UDP_BATCH_SLOT_SIZE, 0, (struct sockaddr *)&batch->receive_address[0], &sender_len);
+    if (recv_len == -1) {
+        perror("an error occured while trying to receive data");
+        abort();
+    }
+
+    batch->receive_offset[0] = 0;
+    batch->receive_length[0] = (size_t)recv_len;
+    batch->received = 1;
+#endif
+    batch->next = 0;
+}
+
+#ifdef USE_UDP_GSO
+/**
+ * Blocks until a datagram is available and splits it into the datagrams the kernel has coalesced
+ */
+static void udp_receive_coalesced(int file_descriptor, struct udp_batch *batch) {
+    struct sockaddr_in sender;
+    struct iovec iov = {batch->receive_buffer, UDP_RECEIVE_BUFFER_SIZE};
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        size_t align; // struct cmsghdr cannot be used, it has a flexible array member
+    } control;
+
+    struct msghdr msg = {0};
+    msg.msg_name = &sender;
+    msg.msg_namelen = sizeof(sender);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t recv_len = recvmsg(file_descriptor, &msg, 0);
+    if (recv_len == -1) {
+        perror("an error occured while trying to receive data");
+        abort();
+    }
+
+    // without the control message, the buffer holds a single datagram
+    size_t segment_size = (size_t)recv_len;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int gso_size;
+            rmemcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+            if (gso_size > 0) {
+                segment_size = (size_t)gso_size;
+            }
+        }
+    }
+
+    unsigned int count = 0;
+    size_t offset = 0;
+    do {
+        // all segments have the same size, except for the last one
+        size_t remaining = (size_t)recv_len - offset;
+        batch->receive_offset[count] = offset;
+        batch->receive_length[count] = remaining < segment_size ? remaining : segment_size;
+        batch->receive_address[count] = sender;
+        offset += batch->receive_length[count];
+        count++;
+    } while (offset < (size_t)recv_len && count < UDP_MAX_SEGMENTS);
+
+    batch->received = count;
+    batch->next = 0;
+}
+#endif
+
+#ifdef USE_MMSG
+union udp_segment_control {
+    char buf[CMSG_SPACE(sizeof(uint16_t))];
+    size_t align;
+};
+
+/**
+ * Fills the message headers for the queued datagrams from index @p start on, with GSO, a message can carry several datagrams
+ * @return the amount of messages, first[i] is the index of the first datagram of message i
+ */
+static unsigned int udp_prepare_messages(struct udp_batch *batch, unsigned int start, struct mmsghdr *msgs, struct iovec *iov, union udp_segment_control *control, unsigned int *first) {
+    unsigned int count = 0;
+    rmemset(msgs, 0, UDP_BATCH_SIZE * sizeof(struct mmsghdr));
+    for (unsigned int i = start; i < batch->queued; count++) {
+        unsigned int segments = 1;
+#ifdef USE_UDP_GSO
+        if (batch->gso && batch->send_length[i] > 0) {
+            // the kernel splits the buffer into datagrams of the size of the first one
+            while (i + segments < batch->queued &&
+                   batch->send_length[i + segments] == batch->send_length[i] &&
+                   batch->send_address[i + segments].sin_addr.s_addr == batch->send_address[i].sin_addr.s_addr &&
+                   batch->send_address[i + segments].sin_port == batch->send_address[i].sin_port) {
+                segments++;
+            }
+        }
+#endif
+
+        for (unsigned int j = i; j < i + segments; j++) {
+            iov[j].iov_base = batch->send_buffer[j];
+            iov[j].iov_len = batch->send_length[j];
+        }
+        msgs[count].msg_hdr.msg_iov = &iov[i];
+        msgs[count].msg_hdr.msg_iovlen = segments;
+        msgs[count].msg_hdr.msg_name = &batch->send_address[i];
+        msgs[count].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+
+#ifdef USE_UDP_GSO
+        if (segments > 1) {
+            msgs[count].msg_hdr.msg_control = control[count].buf;
+            msgs[count].msg_hdr.msg_controllen = sizeof(control[count].buf);
+            struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[count].msg_hdr);
+            cmsg->cmsg_level = IPPROTO_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t segment_size = (uint16_t)batch->send_length[i];
+            rmemcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+        }
+#else
+        UNUSED(control);
+#endif
+
+        first[count] = i;
+        i += segments;
+    }
+    return count;
+}
+#endif
+
+/**
+ * Sends all queued datagrams
+ */
+static void udp_send_batch(int file_descriptor, struct udp_batch *batch) {
+#ifdef USE_MMSG
+    struct mmsghdr msgs[UDP_BATCH_SIZE];
+    struct iovec iov[UDP_BATCH_SIZE];
+    union udp_segment_control control[UDP_BATCH_SIZE];
+    unsigned int first[UDP_BATCH_SIZE];
+
+    // sendmmsg may stop early, continue with the remaining datagrams
+    unsigned int sent = 0;
+    while (sent < batch->queued) {
+        unsigned int count = udp_prepare_messages(batch, sent, msgs, iov, control, first);
+        int sent_messages = sendmmsg(file_descriptor, msgs, count, 0);
+        if (sent_messages < 0) {
+#ifdef USE_UDP_GSO
+            if (batch->gso && (errno == EIO || errno == EINVAL)) {
+                // the device cannot segment the buffer (e.g. no checksum offload, or the datagrams exceed the MTU)
+                batch->gso = false;
+                continue;
+            }
+#endif
+            perror("failed to send data");
+            abort();
+        }
+        sent = (unsigned int)sent_messages < count ? first[sent_messages] : batch->queued;
+    }
+#else
+    for (unsigned int i = 0; i < batch->queued; i++) {
+        bsd_send_sockaddr(file_descriptor, batch->send_buffer[i], batch->send_length[i], batch->send_address[i]);
+    }
+#endif
+    batch->queued = 0;
+}
+
 void handle_tls_mode(rasta_transport_socket *transport_socket) {
     UNUSED(transport_socket);
 }
 
 void udp_close(rasta_transport_socket *transport_socket) {
+    if (transport_socket->batch != NULL) {
+        udp_flush(transport_socket);
+        rfree(transport_socket->batch);
+        transport_socket->batch = NULL;
+    }
     bsd_close(transport_socket->file_descriptor);
 }
 
 size_t udp_receive(rasta_transport_socket *transport_socket, unsigned char *received_message, size_t max_buffer_len, struct sockaddr_in *sender) {
-    ssize_t recv_len;
-    struct sockaddr_in empty_sockaddr_in;
-    socklen_t sender_len = sizeof(empty_sockaddr_in);
+    struct udp_batch *batch = udp_get_batch(transport_socket);
 
     // wait for incoming data
-    if ((recv_len = recvfrom(transport_socket->file_descriptor, received_message, max_buffer_len, 0, (struct sockaddr *)sender, &sender_len)) == -1) {
-        perror("an error occured while trying to receive data");
-        abort();
+    if (batch->next == batch->received) {
+#ifdef USE_UDP_GSO
+        if (batch->gro) {
+            udp_receive_coalesced(transport_socket->file_descriptor, batch);
+        } else {
+            udp_receive_batch(transport_socket->file_descriptor, batch);
+        }
+#else
+        udp_receive_batch(transport_socket->file_descriptor, batch);
+#endif
     }
 
-    return (size_t)recv_len;
+    unsigned int i = batch->next++;
+    size_t recv_len = batch->receive_length[i];
+    if (recv_len > max_buffer_len) {
+        // same as recvfrom, excess bytes of the datagram are discarded
+        recv_len = max_buffer_len;
+    }
+    rmemcpy(received_message, &batch->receive_buffer[batch->receive_offset[i]], recv_len);
+    *sender = batch->receive_address[i];
+
+    return recv_len;
+}
+
+bool udp_receive_pending(rasta_transport_socket *transport_socket) {
+    struct udp_batch *batch = transport_socket->batch;
+    return batch != NULL && batch->next < batch->received;
 }
 
 void udp_send(rasta_transport_channel *transport_channel, unsigned char *message, size_t message_len, char *host, uint16_t port) {
-    bsd_send(transport_channel->file_descriptor, message, message_len, host, port);
+    struct sockaddr_in receiver = host_port_to_sockaddr(host, port);
+    udp_send_sockaddr(transport_channel, message, message_len, receiver);
 }
 
 void udp_send_sockaddr(rasta_transport_channel *transport_channel, unsigned char *message, size_t message_len, struct sockaddr_in receiver) {
-    bsd_send_sockaddr(transport_channel->file_descriptor, message, message_len, receiver);
+    rasta_transport_socket *transport_socket = transport_channel->associated_socket;
+    struct udp_batch *batch = transport_socket != NULL ? transport_socket->batch : NULL;
+
+    if (batch == NULL || !batch->corked || message_len > UDP_BATCH_SLOT_SIZE) {
+        if (batch != NULL && batch->queued > 0) {
+            // keep the order of the datagrams
+            udp_send_batch(transport_socket->file_descriptor, batch);
+        }
+        bsd_send_sockaddr(transport_channel->file_descriptor, message, message_len, receiver);
+        return;
+    }
+
+    if (batch->queued == UDP_BATCH_SIZE) {
+        udp_send_batch(transport_socket->file_descriptor, batch);
+    }
+
+    // the caller may free the message right after this call, so it is copied into the batch
+    rmemcpy(batch->send_buffer[batch->queued], message, message_len);
+    batch->send_length[batch->queued] = message_len;
+    batch->send_address[batch->queued] = receiver;
+    batch->queued++;
+}
+
+void udp_enable_offload(rasta_transport_socket *transport_socket) {
+    struct udp_batch *batch = udp_get_batch(transport_socket);
+#ifdef USE_UDP_GSO
+    // the segment size is passed with each message, reading the socket default only checks for kernel support
+    int segment_size = 0;
+    socklen_t option_len = sizeof(segment_size);
+    batch->gso = getsockopt(transport_socket->file_descriptor, IPPROTO_UDP, UDP_SEGMENT, &segment_size, &option_len) == 0;
+
+    int one = 1;
+    batch->gro = setsockopt(transport_socket->file_descriptor, IPPROTO_UDP, UDP_GRO, &one, sizeof(one)) == 0;
+#else
+    UNUSED(batch);
+#endif
+}
+
+bool udp_offload_enabled(rasta_transport_socket *transport_socket) {
+    struct udp_batch *batch = transport_socket->batch;
+    return batch != NULL && (batch->gso || batch->gro);
+}
+
+void udp_cork(rasta_transport_socket *transport_socket) {
+    udp_get_batch(transport_socket)->corked = true;
+}
+
+void udp_flush(rasta_transport_socket *transport_socket) {
+    struct udp_batch *batch = transport_socket->batch;
+    if (batch == NULL) {
+        return;
+    }
+
+    if (batch->queued > 0) {
+        udp_send_batch(transport_socket->file_descriptor, batch);
+    }
+    batch->corked = false;
 }
 
 bool is_dtls_conn_ready(rasta_transport_socket *socket) {
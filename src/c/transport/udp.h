@@ -8,6 +8,11 @@
 
 #include "transport.h"
 
+/**
+ * the maximum amount of datagrams that are received or sent with one system call
+ */
+#define UDP_BATCH_SIZE 16
+
 void handle_tls_mode(rasta_transport_socket *transport_socket);
 
 /**
@@ -21,6 +26,13 @@ void handle_tls_mode(rasta_transport_socket *transport_socket);
  */
 size_t udp_receive(rasta_transport_socket *transport_socket, unsigned char *received_message, size_t max_buffer_len, struct sockaddr_in *sender);
 
+/**
+ * Checks if datagrams of the last receive call have not been handed out by udp_receive yet.
+ * @param transport_socket transport_socket which is used to receive data
+ * @return true if the next call to udp_receive returns without blocking
+ */
+bool udp_receive_pending(rasta_transport_socket *transport_socket);
+
 /**
  * Sends a message via the given file descriptor to a @p host and @p port
  * @param transport_channel transport_channel which is used to send the message
@@ -42,6 +54,32 @@ void udp_send(rasta_transport_channel *transport_channel, unsigned char *message
  */
 void udp_send_sockaddr(rasta_transport_channel *transport_channel, unsigned char *message, size_t message_len, struct sockaddr_in receiver);
 
+/**
+ * Lets the kernel segment queued equal-sized datagrams to the same receiver (UDP_SEGMENT) and coalesce received
+ * datagrams (UDP_GRO), if the kernel supports it. Otherwise datagrams are still sent and received individually.
+ * @param transport_socket the rasta_transport_socket which identifies the socket
+ */
+void udp_enable_offload(rasta_transport_socket *transport_socket);
+
+/**
+ * Checks if segmentation or receive offload is used for the socket.
+ * @param transport_socket the rasta_transport_socket which identifies the socket
+ * @return true if udp_enable_offload has enabled any offload
+ */
+bool udp_offload_enabled(rasta_transport_socket *transport_socket);
+
+/**
+ * Starts queueing the messages that are sent via the given socket, so they can be sent with one system call.
+ * @param transport_socket the rasta_transport_socket which identifies the socket
+ */
+void udp_cork(rasta_transport_socket *transport_socket);
+
+/**
+ * Sends the messages that have been queued since udp_cork and stops queueing.
+ * @param transport_socket the rasta_transport_socket which identifies the socket
+ */
+void udp_flush(rasta_transport_socket *transport_socket);
+
 /**
  * Closes the udp socket
  * @param transport_socket the rasta_transport_socket which identifies the socket
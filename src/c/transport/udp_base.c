@@ -2,6 +2,7 @@
 
 #include <stdlib.h>
 
+#include "../logging.h"
 #include "../rastahandle.h"
 #include "bsd_utils.h"
 
@@ -13,6 +14,13 @@ void transport_create_socket(struct rasta_handle *h, rasta_transport_socket *soc
     socket->tls_config = tls_config;
     socket->file_descriptor = bsd_create_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 
+    if (h->config != NULL && h->config->redundancy.udp_offload) {
+        udp_enable_offload(socket);
+        if (!udp_offload_enabled(socket)) {
+            logger_log(h->logger, LOG_LEVEL_INFO, "RaSTA UDP", "segmentation offload is not supported, sending datagrams individually");
+        }
+    }
+
     memset(&socket->receive_event, 0, sizeof(fd_event));
     socket->receive_event.callback = channel_receive_event;
     socket->receive_event.carry_data = &socket->receive_event_data;
@@ -86,6 +94,41 @@ void send_callback(struct RastaByteArray data_to_send, rasta_transport_channel *
     udp_send(channel, data_to_send.bytes, data_to_send.length, channel->remote_ip_address, channel->remote_port);
 }
 
-ssize_t receive_callback(struct receive_event_data *data, unsigned char *buffer, struct sockaddr_in *sender) {
-    return udp_receive(data->socket, buffer, MAX_DEFER_QUEUE_MSG_SIZE, sender);
+void transport_free_channel(rasta_transport_channel *channel) {
+    UNUSED(channel);
+}
+
+ssize_t receive_callback(struct receive_event_data *data, unsigned char **buffer, struct sockaddr_in *sender) {
+    // when performing DTLS accept, len = 0 doesn't signal a broken connection
+    bool is_dtls_conn_ready_result = is_dtls_conn_ready(data->socket);
+
+    size_t len = udp_receive(data->socket, *buffer, MAX_DEFER_QUEUE_MSG_SIZE, sender);
+    if (len == 0 && !is_dtls_conn_ready_result) {
+        return -1;
+    }
+    return (ssize_t)len;
+}
+
+bool transport_receive_pending(struct receive_event_data *data) {
+    return data->socket != NULL && data->socket->file_descriptor >= 0 && udp_receive_pending(data->socket);
+}
+
+void transport_cork(rasta_transport_socket *socket) {
+    if (socket->file_descriptor >= 0) {
+        udp_cork(socket);
+    }
+}
+
+void transport_flush(rasta_transport_socket *socket) {
+    udp_flush(socket);
+}
+
+void transport_send_queued(rasta_transport_channel *channel) {
+    // datagrams are never queued per channel
+    UNUSED(channel);
+}
+
+bool transport_can_send(rasta_transport_channel *channel) {
+    UNUSED(channel);
+    return true;
 }
@@ -0,0 +1,79 @@
+#include "diagnostics_window.h"
+
+#include "rmemory.h"
+
+#define OCCUPIED_BITS 64
+
+static void set_slot(struct diagnostics_window *window, uint32_t seq_nr, int occupied) {
+    unsigned int slot = seq_nr & (window->capacity - 1);
+    if (occupied) {
+        window->occupied[slot / OCCUPIED_BITS] |= (uint64_t)1 << (slot % OCCUPIED_BITS);
+    } else {
+        window->occupied[slot / OCCUPIED_BITS] &= ~((uint64_t)1 << (slot % OCCUPIED_BITS));
+    }
+}
+
+struct diagnostics_window diagnostics_window_init(unsigned int size) {
+    struct diagnostics_window window;
+
+    window.capacity = OCCUPIED_BITS;
+    while (window.capacity < size) {
+        window.capacity <<= 1;
+    }
+
+    window.timestamps = rmalloc_tagged(RASTA_MEMORY_TAG_DEFERQUEUE, window.capacity * sizeof(unsigned long));
+    window.occupied = rmalloc_tagged(RASTA_MEMORY_TAG_DEFERQUEUE, window.capacity / OCCUPIED_BITS * sizeof(uint64_t));
+    diagnostics_window_clear(&window);
+
+    return window;
+}
+
+void diagnostics_window_destroy(struct diagnostics_window *window) {
+    rfree(window->timestamps);
+    rfree(window->occupied);
+
+    window->capacity = 0;
+    window->count = 0;
+}
+
+void diagnostics_window_add(struct diagnostics_window *window, uint32_t seq_nr, unsigned long recv_ts) {
+    if (window->count == 0) {
+        window->latest = seq_nr;
+    }
+
+    uint32_t ahead = seq_nr - window->latest;
+    if ((int32_t)ahead > 0) {
+        // the window moves forward, forget the sequence numbers in between
+        uint32_t skipped = ahead - 1 < window->capacity ? ahead - 1 : window->capacity;
+        for (uint32_t i = 1; i <= skipped; i++) {
+            set_slot(window, window->latest + i, 0);
+        }
+        window->latest = seq_nr;
+    } else if (window->latest - seq_nr >= window->capacity) {
+        // too old to be remembered
+        return;
+    }
+
+    window->timestamps[seq_nr & (window->capacity - 1)] = recv_ts;
+    set_slot(window, seq_nr, 1);
+    window->count++;
+}
+
+unsigned long diagnostics_window_get_ts(struct diagnostics_window *window, uint32_t seq_nr) {
+    // sequence numbers ahead of the latest one wrap around to large distances as well
+    if (window->count == 0 || window->latest - seq_nr >= window->capacity) {
+        return 0;
+    }
+
+    unsigned int slot = seq_nr & (window->capacity - 1);
+    if (!((window->occupied[slot / OCCUPIED_BITS] >> (slot % OCCUPIED_BITS)) & 1)) {
+        return 0;
+    }
+    return window->timestamps[slot];
+}
+
+void diagnostics_window_clear(struct diagnostics_window *window) {
+    rmemset(window->occupied, 0, window->capacity / OCCUPIED_BITS * sizeof(uint64_t));
+    window->count = 0;
+    window->latest = 0;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Sliding window over the sequence numbers of the PDUs that were received first on a redundancy channel,
+ * remembering the time each one was received. Used to calculate the delay of the other transport channels.
+ * The receive timestamps are kept in a ring indexed by the sequence number, a bitmap marks the slots that are set.
+ */
+struct diagnostics_window {
+    /**
+     * the amount of slots in the ring, a power of two
+     */
+    unsigned int capacity;
+
+    /**
+     * the amount of sequence numbers that were added since the window was cleared
+     */
+    unsigned int count;
+
+    /**
+     * the largest sequence number that was added, the ring covers the capacity sequence numbers up to it
+     */
+    uint32_t latest;
+
+    /**
+     * the receive timestamp for every slot of the ring
+     */
+    unsigned long *timestamps;
+
+    /**
+     * bitmap of the slots of the ring that are set
+     */
+    uint64_t *occupied;
+};
+
+/**
+ * initializes an empty window
+ * @param size the amount of sequence numbers that are remembered at least
+ * @return an initialized window
+ */
+struct diagnostics_window diagnostics_window_init(unsigned int size);
+
+/**
+ * frees the memory of the window
+ * @param window the window that will be destroyed
+ */
+void diagnostics_window_destroy(struct diagnostics_window *window);
+
+/**
+ * remembers the receive timestamp of a sequence number, sequence numbers that are further behind
+ * the latest one than the window covers are forgotten
+ * @param window the window that is used
+ * @param seq_nr the sequence number of the received PDU
+ * @param recv_ts the time the PDU was received
+ */
+void diagnostics_window_add(struct diagnostics_window *window, uint32_t seq_nr, unsigned long recv_ts);
+
+/**
+ * gets the receive timestamp of a sequence number
+ * @param window the window that is used
+ * @param seq_nr the sequence number that is searched for
+ * @return the timestamp if the sequence number is in the window, 0 otherwise
+ */
+unsigned long diagnostics_window_get_ts(struct diagnostics_window *window, uint32_t seq_nr);
+
+/**
+ * forgets all sequence numbers in the window
+ * @param window the window that is cleared
+ */
+void diagnostics_window_clear(struct diagnostics_window *window);
@@ -1,14 +1,20 @@
 #include "event_system.h"
 
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <sys/select.h>
+#ifdef USE_EPOLL
+#include <sys/timerfd.h>
+#endif
 #include <time.h>
 
 #include <rasta/rasta.h>
 
 #include "../rastahandle.h"
 #include "rastautil.h"
+#include "rmemory.h"
 
 uint64_t get_nanotime() {
     struct timespec t;
@@ -16,6 +22,309 @@ uint64_t get_nanotime() {
     return t.tv_sec * NS_PER_S + t.tv_nsec;
 }
 
+// returned by event_system_sleep if a callback requested to stop the event loop
+#define EVENT_SYSTEM_STOPPED -2
+
+#ifdef USE_EPOLL
+
+// maximum amount of ready fds that are dispatched per wakeup, remaining ones are reported by the next epoll_wait
+#define EPOLL_MAX_EVENTS 64
+
+// marks a registration whose fd could not be added to the epoll instance
+#define EV_UNPOLLABLE (1 << 7)
+
+static void event_system_arm_timer(event_system *ev_sys);
+
+/**
+ * returns the epoll instance of the event system, creating it if necessary
+ * @param ev_sys the event system
+ * @return the epoll fd or -1 if it could not be created
+ */
+static int event_system_epoll_fd(event_system *ev_sys) {
+    if (!ev_sys->epoll_initialized) {
+        ev_sys->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (ev_sys->epoll_fd == -1) {
+            perror("epoll_create1 failed");
+            return -1;
+        }
+        ev_sys->epoll_initialized = true;
+    }
+    return ev_sys->epoll_fd;
+}
+
+static uint32_t epoll_event_mask(int options) {
+    uint32_t events = 0;
+    if (options & EV_READABLE)
+        events |= EPOLLIN;
+    if (options & EV_WRITABLE)
+        events |= EPOLLOUT;
+    if (options & EV_EXCEPTIONAL)
+        events |= EPOLLPRI;
+    return events;
+}
+
+/**
+ * removes the event from the interest list of its event system, if it is registered
+ * @param event the event to unregister
+ */
+static void fd_event_unregister(fd_event *event) {
+    if (!event->registered_options) {
+        return;
+    }
+
+    if (event->registered_options & EV_UNPOLLABLE) {
+        event->ev_sys->unpollable_count--;
+        event_system_arm_timer(event->ev_sys);
+    } else {
+        // fails if the fd has already been closed, which implicitly removed it from the interest list
+        epoll_ctl(event->ev_sys->epoll_fd, EPOLL_CTL_DEL, event->registered_fd, NULL);
+    }
+    event->registered_options = 0;
+}
+
+/**
+ * updates the interest list of the event system to match the fd, options and enabled state of the event
+ * @param event the event to update
+ */
+static void fd_event_update_registration(fd_event *event) {
+    event_system *ev_sys = event->ev_sys;
+    if (ev_sys == NULL) {
+        // the event will be registered when it is added to an event system
+        return;
+    }
+
+    if (!event->enabled || !event->options || event->fd < 0) {
+        fd_event_unregister(event);
+        return;
+    }
+
+    int epoll_fd = event_system_epoll_fd(ev_sys);
+    if (epoll_fd == -1) {
+        return;
+    }
+
+    struct epoll_event ev = {0};
+    ev.events = epoll_event_mask(event->options);
+    ev.data.ptr = event;
+
+    if (event->registered_options && !(event->registered_options & EV_UNPOLLABLE) && event->registered_fd == event->fd) {
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, event->fd, &ev) == 0) {
+            event->registered_options = event->options;
+            return;
+        }
+        // the fd has been closed and reopened with the same number, so it has to be added again
+    }
+    fd_event_unregister(event);
+
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, event->fd, &ev) == 0) {
+        event->registered_fd = event->fd;
+        event->registered_options = event->options;
+    } else if (errno == EPERM) {
+        // epoll refuses fds like regular files, which select reports as always ready
+        event->registered_fd = event->fd;
+        event->registered_options = event->options | EV_UNPOLLABLE;
+        ev_sys->unpollable_count++;
+        event_system_arm_timer(ev_sys);
+    } else {
+        perror("epoll_ctl failed");
+    }
+}
+
+/**
+ * calls the callback of a ready event once for every requested condition that occurred
+ * @param event the ready event
+ * @param revents the epoll events that occurred
+ * @return 0 to continue, everything else to terminate the event loop
+ */
+static int fd_event_dispatch(fd_event *event, uint32_t revents) {
+    // select reports hangups and errors as readable (and writable), keep that behaviour
+    if (event->enabled && (event->options & EV_READABLE) && (revents & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+        if (event->callback(event->carry_data, event->fd)) return 1;
+    }
+    if (event->enabled && (event->options & EV_WRITABLE) && (revents & (EPOLLOUT | EPOLLHUP | EPOLLERR))) {
+        if (event->callback(event->carry_data, event->fd)) return 1;
+    }
+    if (event->enabled && (event->options & EV_EXCEPTIONAL) && (revents & EPOLLPRI)) {
+        if (event->callback(event->carry_data, event->fd)) return 1;
+    }
+    return 0;
+}
+
+static int timer_fd_callback(void *carry_data, int fd) {
+    event_system *ev_sys = carry_data;
+    // acknowledge the expiration, the due timed events are fired by the event loop
+    uint64_t expirations;
+    ssize_t ignored = read(fd, &expirations, sizeof(expirations));
+    (void)ignored;
+    // the timer is disarmed now, it has to be armed again even if the next deadline did not change
+    ev_sys->armed_deadline = 0;
+    return 0;
+}
+
+/**
+ * arms the timer fd of the event system to the deadline of the next timed event,
+ * so the epoll fd becomes readable when a timed event is due while no loop is running
+ * @param ev_sys the event system
+ */
+static void event_system_arm_timer(event_system *ev_sys) {
+    if (!ev_sys->timer_fd_initialized || ev_sys->loop_running) {
+        return;
+    }
+
+    uint64_t deadline = 0;
+    if (ev_sys->unpollable_count > 0) {
+        // unpollable fds are always ready
+        deadline = 1;
+    } else if (ev_sys->timed_event_queue.size > 0) {
+        timed_event *next = ev_sys->timed_event_queue.events[0];
+        deadline = next->last_call + next->interval;
+        // a zero expiration would disarm the timer
+        deadline = deadline ? deadline : 1;
+    }
+    if (deadline == ev_sys->armed_deadline) {
+        return;
+    }
+
+    struct itimerspec spec = {0};
+    spec.it_value.tv_sec = deadline / NS_PER_S;
+    spec.it_value.tv_nsec = deadline % NS_PER_S;
+    if (timerfd_settime(ev_sys->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) == -1) {
+        perror("timerfd_settime failed");
+        return;
+    }
+    ev_sys->armed_deadline = deadline;
+}
+
+int event_system_fd(event_system *ev_sys) {
+    int epoll_fd = event_system_epoll_fd(ev_sys);
+    if (epoll_fd == -1 || ev_sys->timer_fd_initialized) {
+        return epoll_fd;
+    }
+
+    // timed events are reported through a timer fd, which uses the clock of get_nanotime
+    ev_sys->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (ev_sys->timer_fd == -1) {
+        perror("timerfd_create failed");
+        return -1;
+    }
+
+    // the timer event is registered with epoll directly, so it is not part of the fd event list
+    rmemset(&ev_sys->timer_event, 0, sizeof(fd_event));
+    ev_sys->timer_event.callback = timer_fd_callback;
+    ev_sys->timer_event.carry_data = ev_sys;
+    ev_sys->timer_event.fd = ev_sys->timer_fd;
+    ev_sys->timer_event.options = EV_READABLE;
+    ev_sys->timer_event.enabled = 1;
+
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &ev_sys->timer_event;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ev_sys->timer_fd, &ev) == -1) {
+        perror("epoll_ctl failed");
+        close(ev_sys->timer_fd);
+        return -1;
+    }
+
+    ev_sys->timer_fd_initialized = true;
+    ev_sys->armed_deadline = 0;
+    event_system_arm_timer(ev_sys);
+    return epoll_fd;
+}
+
+/**
+ * sleeps but keeps track of the fd events
+ * @param time_to_wait the time to sleep in nanoseconds
+ * @param ev_sys the event system containing the fd events
+ * @return the amount of fd events that got called, EVENT_SYSTEM_STOPPED if an fd event stopped the loop or -1 on error
+ */
+int event_system_sleep(uint64_t time_to_wait, event_system *ev_sys) {
+    int epoll_fd = event_system_epoll_fd(ev_sys);
+    if (epoll_fd == -1) {
+        return -1;
+    }
+
+    int timeout = -1;
+    if (ev_sys->unpollable_count > 0) {
+        // unpollable fds are always ready
+        timeout = 0;
+    } else if (time_to_wait != UINT64_MAX) {
+        // round up, waking up before the next timed event is due would only spin the loop
+        uint64_t timeout_ms = (time_to_wait + NS_PER_MS - 1) / NS_PER_MS;
+        timeout = timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms;
+    }
+
+    // wait
+    struct epoll_event ready_events[EPOLL_MAX_EVENTS];
+    int result = epoll_wait(epoll_fd, ready_events, EPOLL_MAX_EVENTS, timeout);
+    if (result == -1) {
+        perror("epoll_wait failed");
+        // syscall error or error on epoll_wait()
+        return -1;
+    }
+
+    // only the ready events are visited, remove_fd_event clears entries of events removed by a callback
+    ev_sys->ready_events = ready_events;
+    ev_sys->ready_count = result;
+    int terminate = 0;
+    for (int i = 0; i < result && !terminate; i++) {
+        fd_event *current = ready_events[i].data.ptr;
+        terminate = current != NULL && fd_event_dispatch(current, ready_events[i].events);
+    }
+    ev_sys->ready_events = NULL;
+    ev_sys->ready_count = 0;
+    if (terminate) {
+        return EVENT_SYSTEM_STOPPED;
+    }
+
+    if (ev_sys->unpollable_count > 0) {
+        for (fd_event *current = ev_sys->fd_events.first; current; current = current->next) {
+            if ((current->registered_options & EV_UNPOLLABLE) && fd_event_dispatch(current, EPOLLIN | EPOLLOUT)) {
+                return EVENT_SYSTEM_STOPPED;
+            }
+        }
+    }
+    return result;
+}
+
+static void event_system_backend_destroy(event_system *ev_sys) {
+    for (fd_event *current = ev_sys->fd_events.first; current; current = current->next) {
+        current->registered_options = 0;
+    }
+    ev_sys->unpollable_count = 0;
+
+    if (ev_sys->timer_fd_initialized) {
+        close(ev_sys->timer_fd);
+        ev_sys->timer_fd_initialized = false;
+    }
+    if (ev_sys->epoll_initialized) {
+        close(ev_sys->epoll_fd);
+        ev_sys->epoll_initialized = false;
+    }
+}
+
+#else
+
+static void fd_event_unregister(fd_event *event) {
+    // select does not keep an interest list
+    (void)event;
+}
+
+static void fd_event_update_registration(fd_event *event) {
+    // the fd sets are rebuilt on every iteration
+    (void)event;
+}
+
+static void event_system_arm_timer(event_system *ev_sys) {
+    // there is no fd to report timed events with
+    (void)ev_sys;
+}
+
+int event_system_fd(event_system *ev_sys) {
+    // select cannot be watched from the outside
+    (void)ev_sys;
+    return -1;
+}
+
 int get_max_nfds(struct fd_event_linked_list_s *fd_events) {
     int nfds = 0;
     // find highest fd and set nfds to 1 higher
@@ -29,17 +338,17 @@ int get_max_nfds(struct fd_event_linked_list_s *fd_events) {
 /**
  * sleeps but keeps track of the fd events
  * @param time_to_wait the time to sleep in nanoseconds
- * @param fd_events the fd event array
- * @param len the length of the fd event array
- * @return the amount of fd events that got called or -1 to terminate the event loop
+ * @param ev_sys the event system containing the fd events
+ * @return the amount of fd events that got called, EVENT_SYSTEM_STOPPED if an fd event stopped the loop or -1 on error
  */
-int event_system_sleep(uint64_t time_to_wait, struct fd_event_linked_list_s *fd_events) {
+int event_system_sleep(uint64_t time_to_wait, event_system *ev_sys) {
+    struct fd_event_linked_list_s *fd_events = &ev_sys->fd_events;
     struct timeval tv;
     tv.tv_sec = time_to_wait / NS_PER_S;
     tv.tv_usec = (time_to_wait / MS_PER_S) % NS_PER_MS;
     int nfds = get_max_nfds(fd_events);
     if (nfds >= FD_SETSIZE) {
-        // too high file desriptors, can be fixed by using poll instead but should not be an issue
+        // too high file desriptors, use the epoll backend (USE_EPOLL) where available
         return -1;
     }
     // zero and set the fd to watch
@@ -69,18 +378,147 @@ int event_system_sleep(uint64_t time_to_wait, struct fd_event_linked_list_s *fd_
     }
     for (fd_event *current = fd_events->first; current; current = current->next) {
         if (current->enabled && FD_ISSET(current->fd, &on_readable)) {
-            if (current->callback(current->carry_data, current->fd)) return -1;
+            if (current->callback(current->carry_data, current->fd)) return EVENT_SYSTEM_STOPPED;
         }
         if (current->enabled && FD_ISSET(current->fd, &on_writable)) {
-            if (current->callback(current->carry_data, current->fd)) return -1;
+            if (current->callback(current->carry_data, current->fd)) return EVENT_SYSTEM_STOPPED;
         }
         if (current->enabled && FD_ISSET(current->fd, &on_exceptional)) {
-            if (current->callback(current->carry_data, current->fd)) return -1;
+            if (current->callback(current->carry_data, current->fd)) return EVENT_SYSTEM_STOPPED;
         }
     }
     return result;
 }
 
+static void event_system_backend_destroy(event_system *ev_sys) {
+    // nothing to release
+    (void)ev_sys;
+}
+
+#endif
+
+void event_system_destroy(event_system *ev_sys) {
+    event_system_backend_destroy(ev_sys);
+
+    for (timed_event *current = ev_sys->timed_events.first; current; current = current->next) {
+        current->queue_index = 0;
+    }
+    rfree(ev_sys->timed_event_queue.events);
+    ev_sys->timed_event_queue.events = NULL;
+    ev_sys->timed_event_queue.size = 0;
+    ev_sys->timed_event_queue.capacity = 0;
+}
+
+/**
+ * the deadline a timed event is ordered by in the timer queue
+ */
+static uint64_t timed_event_deadline(const timed_event *event) {
+    return event->last_call + event->interval;
+}
+
+static void timed_event_queue_set(struct timed_event_heap_s *queue, unsigned int index, timed_event *event) {
+    queue->events[index] = event;
+    event->queue_index = index + 1;
+}
+
+/**
+ * moves the event at index towards the root of the timer queue until its parent is due earlier
+ */
+static void timed_event_queue_sift_up(struct timed_event_heap_s *queue, unsigned int index) {
+    timed_event *event = queue->events[index];
+    uint64_t deadline = timed_event_deadline(event);
+    while (index > 0) {
+        unsigned int parent = (index - 1) / 2;
+        if (timed_event_deadline(queue->events[parent]) <= deadline) {
+            break;
+        }
+        timed_event_queue_set(queue, index, queue->events[parent]);
+        index = parent;
+    }
+    timed_event_queue_set(queue, index, event);
+}
+
+/**
+ * moves the event at index towards the leaves of the timer queue until its children are due later
+ */
+static void timed_event_queue_sift_down(struct timed_event_heap_s *queue, unsigned int index) {
+    timed_event *event = queue->events[index];
+    uint64_t deadline = timed_event_deadline(event);
+    for (;;) {
+        unsigned int child = 2 * index + 1;
+        if (child >= queue->size) {
+            break;
+        }
+        if (child + 1 < queue->size && timed_event_deadline(queue->events[child + 1]) < timed_event_deadline(queue->events[child])) {
+            child++;
+        }
+        if (deadline <= timed_event_deadline(queue->events[child])) {
+            break;
+        }
+        timed_event_queue_set(queue, index, queue->events[child]);
+        index = child;
+    }
+    timed_event_queue_set(queue, index, event);
+}
+
+/**
+ * removes the event from the timer queue of its event system, if it is scheduled
+ * @param event the event to unschedule
+ */
+static void timed_event_unschedule(timed_event *event) {
+    if (!event->queue_index) {
+        return;
+    }
+
+    struct timed_event_heap_s *queue = &event->ev_sys->timed_event_queue;
+    unsigned int index = event->queue_index - 1;
+    event->queue_index = 0;
+
+    // fill the gap with the last event and restore the heap property around it
+    timed_event *last = queue->events[--queue->size];
+    if (index < queue->size) {
+        timed_event_queue_set(queue, index, last);
+        timed_event_queue_sift_up(queue, index);
+        timed_event_queue_sift_down(queue, last->queue_index - 1);
+    }
+    event_system_arm_timer(event->ev_sys);
+}
+
+/**
+ * updates the position of the event in the timer queue of its event system to match its enabled state and deadline
+ * @param event the event to update
+ */
+static void timed_event_schedule(timed_event *event) {
+    event_system *ev_sys = event->ev_sys;
+    if (ev_sys == NULL) {
+        // the event will be scheduled when it is added to an event system
+        return;
+    }
+
+    if (!event->enabled) {
+        timed_event_unschedule(event);
+        return;
+    }
+
+    struct timed_event_heap_s *queue = &ev_sys->timed_event_queue;
+    if (event->queue_index) {
+        // the deadline moved, only one of the sifts actually moves the event
+        timed_event_queue_sift_up(queue, event->queue_index - 1);
+        timed_event_queue_sift_down(queue, event->queue_index - 1);
+        event_system_arm_timer(ev_sys);
+        return;
+    }
+
+    if (queue->size == queue->capacity) {
+        queue->capacity = queue->capacity ? 2 * queue->capacity : 16;
+        queue->events = rrealloc(queue->events, queue->capacity * sizeof(timed_event *));
+    }
+    timed_event_queue_set(queue, queue->size, event);
+    queue->size++;
+    timed_event_queue_sift_up(queue, queue->size - 1);
+    event_system_arm_timer(ev_sys);
+}
+
 /**
  * reschedules the event to the current time + the event interval
  * resulting in a delay of the event
@@ -88,80 +526,119 @@ int event_system_sleep(uint64_t time_to_wait, struct fd_event_linked_list_s *fd_
  */
 void reschedule_event(timed_event *event) {
     event->last_call = get_nanotime();
+    timed_event_schedule(event);
 }
 
 /**
  * calculates the next timed event that has to be called and the time to wait for it
- * @param timed_events array of the events
- * @param len the lenght of the array
- * @param next_event_index the index of the next event will be written in here, can be NULL
+ * @param queue the timer queue of the event system
+ * @param next_timed_event the next event will be written in here, can be NULL
  * @param cur_time the current time
  * @return uint64_t the time to wait
  */
-uint64_t calc_next_timed_event(struct timed_event_linked_list_s *timed_events, timed_event **next_timed_event, uint64_t cur_time) {
-    uint64_t time_to_wait = UINT64_MAX;
-    for (timed_event *current = timed_events->first; current; current = current->next) {
-        if (current->enabled) {
-            uint64_t continue_at = current->last_call + current->interval;
-            if (continue_at <= cur_time) {
-                if (next_timed_event) {
-                    *next_timed_event = current;
-                }
-                return 0;
-            } else {
-                uint64_t new_time_to_wait = continue_at - cur_time;
-                if (new_time_to_wait < time_to_wait) {
-                    if (next_timed_event) {
-                        *next_timed_event = current;
-                    }
-                    time_to_wait = new_time_to_wait;
-                }
-            }
-        }
+static uint64_t calc_next_timed_event(struct timed_event_heap_s *queue, timed_event **next_timed_event, uint64_t cur_time) {
+    if (queue->size == 0) {
+        return UINT64_MAX;
     }
-    return time_to_wait;
+
+    // only enabled events are queued, the root is due first
+    timed_event *next = queue->events[0];
+    if (next_timed_event) {
+        *next_timed_event = next;
+    }
+    uint64_t continue_at = timed_event_deadline(next);
+    return continue_at <= cur_time ? 0 : continue_at - cur_time;
 }
 
 /**
- * starts an event loop with the given events
- * the events may not be removed while the loop is running, but can be modified
- * @param ev_sys contains all the events the loop should handel.
- * Can be modified from the calling thread while running.
+ * moves the deadline of a timed event that just fired to its next period
+ * @param event the event that fired
+ * @param last_call the timed_event::last_call before the event fired
+ * @param cur_time the time the event fired at
  */
-void event_system_start(event_system *ev_sys) {
+static void timed_event_advance(timed_event *event, uint64_t last_call, uint64_t cur_time) {
+    if (event->last_call != last_call) {
+        // the callback rescheduled the event itself
+        return;
+    }
+    // keep the phase of the event unless it fell behind by more than an interval, e.g. while the loop was not running
+    uint64_t deadline = last_call + event->interval;
+    event->last_call = deadline + event->interval > cur_time ? deadline : cur_time;
+    timed_event_schedule(event);
+}
+
+static int event_system_run_loop(event_system *ev_sys, uint64_t timeout) {
     uint64_t cur_time = get_nanotime();
-    for (timed_event *current = ev_sys->timed_events.first; current; current = current->next) {
-        current->last_call = cur_time;
+    uint64_t end_time = timeout > UINT64_MAX - cur_time ? UINT64_MAX : cur_time + timeout;
+
+    // timed events may have become due while the loop was not running,
+    // handle pending fd events first so e.g. received heartbeats are seen before the timeout fires
+    int result;
+    bool polled = false;
+    if (calc_next_timed_event(&ev_sys->timed_event_queue, NULL, cur_time) == 0) {
+        result = event_system_sleep(0, ev_sys);
+        if (result < 0) {
+            return result == EVENT_SYSTEM_STOPPED ? 1 : -1;
+        }
+        polled = true;
     }
-    for (;;) {
+
+    while (!ev_sys->stop_requested) {
         timed_event *next_event;
         cur_time = get_nanotime();
-        uint64_t time_to_wait = calc_next_timed_event(&ev_sys->timed_events, &next_event, cur_time);
-        if (time_to_wait == UINT64_MAX) {
-            // there are no active events - just wait for fd events
-            int result = event_system_sleep(time_to_wait, &ev_sys->fd_events);
-            if (result == -1) {
-                break;
+        uint64_t time_to_wait = calc_next_timed_event(&ev_sys->timed_event_queue, &next_event, cur_time);
+        if (time_to_wait != 0) {
+            if (cur_time >= end_time && polled) {
+                return 0;
             }
-            continue;
-        } else if (time_to_wait != 0) {
-            int result = event_system_sleep(time_to_wait, &ev_sys->fd_events);
-            if (result == -1) {
-                // select failed, exit loop
-                return;
-            } else if (result >= 0) {
-                // the sleep didn't time out, but a fd event occurred
-                // recalculate next timed event in case one got rescheduled
-                continue;
+            // UINT64_MAX (no active timed events and no timeout) waits for fd events only
+            uint64_t time_left = cur_time >= end_time ? 0 : end_time == UINT64_MAX ? UINT64_MAX : end_time - cur_time;
+            result = event_system_sleep(time_to_wait < time_left ? time_to_wait : time_left, ev_sys);
+            if (result < 0) {
+                return result == EVENT_SYSTEM_STOPPED ? 1 : -1;
             }
+            polled = true;
+            // recalculate next timed event in case one got rescheduled by a fd event or the wait timed out
+            continue;
         }
         // fire event and exit in case it returns something else than 0
-        if (next_event->callback(next_event->carry_data, -1)) {
-            break;
+        uint64_t last_call = next_event->last_call;
+        int stop = next_event->callback(next_event->carry_data, -1);
+        timed_event_advance(next_event, last_call, cur_time);
+        if (stop) {
+            return 1;
         }
-        // update timed_event::last_call
-        next_event->last_call = cur_time + time_to_wait;
     }
+    ev_sys->stop_requested = false;
+    return 1;
+}
+
+int event_system_run(event_system *ev_sys, uint64_t timeout) {
+#ifdef USE_EPOLL
+    // the timer fd only has to be armed when control is handed back to an external event loop
+    bool nested = ev_sys->loop_running;
+    ev_sys->loop_running = true;
+    int result = event_system_run_loop(ev_sys, timeout);
+    ev_sys->loop_running = nested;
+    event_system_arm_timer(ev_sys);
+    return result;
+#else
+    return event_system_run_loop(ev_sys, timeout);
+#endif
+}
+
+/**
+ * starts an event loop with the given events
+ * the events may not be removed while the loop is running, but can be modified
+ * @param ev_sys contains all the events the loop should handel.
+ * Can be modified from the calling thread while running.
+ */
+void event_system_start(event_system *ev_sys) {
+    event_system_run(ev_sys, UINT64_MAX);
+}
+
+void event_system_stop(event_system *ev_sys) {
+    ev_sys->stop_requested = true;
 }
 
 /**
@@ -179,6 +656,7 @@ void enable_timed_event(timed_event *event) {
  */
 void disable_timed_event(timed_event *event) {
     event->enabled = 0;
+    timed_event_unschedule(event);
 }
 
 /**
@@ -187,6 +665,7 @@ void disable_timed_event(timed_event *event) {
  */
 void enable_fd_event(fd_event *event) {
     event->enabled = 1;
+    fd_event_update_registration(event);
 }
 
 /**
@@ -195,6 +674,20 @@ void enable_fd_event(fd_event *event) {
  */
 void disable_fd_event(fd_event *event) {
     event->enabled = 0;
+    fd_event_update_registration(event);
+}
+
+/**
+ * changes the conditions a fd event is triggered for, e.g. to watch a socket for writability only while data is queued
+ * @param event the event to change
+ * @param options the new conditions (EV_READABLE | EV_WRITABLE | EV_EXCEPTIONAL)
+ */
+void set_fd_event_options(fd_event *event, int options) {
+    if (event->options == options) {
+        return;
+    }
+    event->options = options;
+    fd_event_update_registration(event);
 }
 
 /**
@@ -220,6 +713,9 @@ void add_timed_event(event_system *ev_sys, timed_event *event) {
         event->next = NULL;
         event->prev = NULL;
     }
+
+    event->ev_sys = ev_sys;
+    timed_event_schedule(event);
 }
 
 /**
@@ -238,6 +734,9 @@ void remove_timed_event(event_system *ev_sys, timed_event *event) {
     }
     if (event->prev) event->prev->next = event->next;
     if (event->next) event->next->prev = event->prev;
+
+    timed_event_unschedule(event);
+    event->ev_sys = NULL;
 }
 
 /**
@@ -265,7 +764,9 @@ void add_fd_event(event_system *ev_sys, fd_event *event, int options) {
         event->prev = NULL;
     }
 
+    event->ev_sys = ev_sys;
     event->options = options;
+    fd_event_update_registration(event);
 }
 
 void rasta_add_fd_event(rasta *rasta, fd_event *event, int options) {
@@ -289,6 +790,17 @@ void remove_fd_event(event_system *ev_sys, fd_event *event) {
     }
     if (event->prev) event->prev->next = event->next;
     if (event->next) event->next->prev = event->prev;
+
+    fd_event_unregister(event);
+#ifdef USE_EPOLL
+    // the event might still be pending in the ready list that is currently dispatched
+    for (int i = 0; i < ev_sys->ready_count; i++) {
+        if (ev_sys->ready_events[i].data.ptr == event) {
+            ev_sys->ready_events[i].data.ptr = NULL;
+        }
+    }
+#endif
+    event->ev_sys = NULL;
 }
 
 void rasta_remove_fd_event(rasta *rasta, fd_event *event) {
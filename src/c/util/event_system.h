@@ -1,16 +1,30 @@
 #pragma once
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <time.h>
 #include <unistd.h>
 
 #include <rasta/events.h>
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 struct timed_event_linked_list_s {
     timed_event *first;
     timed_event *last;
 };
 
+/**
+ * binary min-heap of the enabled timed events, ordered by timed_event::last_call + timed_event::interval
+ */
+struct timed_event_heap_s {
+    timed_event **events;
+    unsigned int size;
+    unsigned int capacity;
+};
+
 struct fd_event_linked_list_s {
     fd_event *first;
     fd_event *last;
@@ -21,20 +35,98 @@ struct fd_event_linked_list_s {
  */
 typedef struct event_system {
     struct timed_event_linked_list_s timed_events;
+    /**
+     * the enabled timed events, so that the next one can be found without visiting all timed events
+     */
+    struct timed_event_heap_s timed_event_queue;
     struct fd_event_linked_list_s fd_events;
+    /**
+     * set by event_system_stop, makes event_system_run return after the current event
+     */
+    bool stop_requested;
+#ifdef USE_EPOLL
+    /**
+     * the epoll instance all enabled fd events are registered with, created on first use
+     */
+    int epoll_fd;
+    bool epoll_initialized;
+    /**
+     * amount of enabled fd events whose fd cannot be watched by epoll (e.g. regular files), these are always ready
+     */
+    unsigned int unpollable_count;
+    /**
+     * the ready list that is currently being dispatched, used to invalidate events that are removed from a callback
+     */
+    struct epoll_event *ready_events;
+    int ready_count;
+    /**
+     * timer fd in the epoll instance that expires when the next timed event is due, created by event_system_fd
+     */
+    int timer_fd;
+    bool timer_fd_initialized;
+    uint64_t armed_deadline;
+    fd_event timer_event;
+    /**
+     * true while event_system_run is running, the timer fd is only armed when it returns
+     */
+    bool loop_running;
+#endif
 } event_system;
 
 /**
- * starts an event loop with the given events
+ * the clock timed events are scheduled with (timed_event::last_call)
+ * @return the current monotonic time in nanoseconds
+ */
+uint64_t get_nanotime();
+
+/**
+ * starts an event loop with the given events and runs it until an event stops it
  * the events may not be removed while the loop is running, but can be modified
  * @param ev_sys contains all the events the loop should handle.
  * Can be modified from the calling thread while running.
  */
 void event_system_start(event_system *ev_sys);
 
+/**
+ * runs the event loop until an event stops it, event_system_stop is called or the timeout expires
+ * timed events keep their schedule between runs, so the loop can be entered repeatedly without shifting their deadlines
+ * @param ev_sys contains all the events the loop should handle
+ * @param timeout the maximum time to run in nanoseconds, UINT64_MAX to run until the loop is stopped
+ * @return 1 if the loop was stopped, 0 if the timeout expired or -1 on error
+ */
+int event_system_run(event_system *ev_sys, uint64_t timeout);
+
+/**
+ * makes the running event loop return after the current event, if no loop is running the next one returns right away
+ * @param ev_sys the event system to stop
+ */
+void event_system_stop(event_system *ev_sys);
+
+/**
+ * returns a file descriptor that becomes readable whenever fd events are ready or a timed event is due,
+ * so the event system can be driven from an external event loop by calling event_system_run with a timeout of 0
+ * @param ev_sys the event system
+ * @return the file descriptor (owned by the event system) or -1 if the backend does not support it (select)
+ */
+int event_system_fd(event_system *ev_sys);
+
+/**
+ * releases the resources held by the event system (e.g. the timer queue or the epoll instance)
+ * the events themselves are not touched
+ * @param ev_sys the event system to clean up
+ */
+void event_system_destroy(event_system *ev_sys);
+
 /**
  * reschedules the event to the current time + the event interval
  * resulting in a delay of the event
  * @param event the event to delay
  */
 void reschedule_event(timed_event *event);
+
+/**
+ * changes the conditions a fd event is triggered for, e.g. to watch a socket for writability only while data is queued
+ * @param event the event to change
+ * @param options the new conditions (EV_READABLE | EV_WRITABLE | EV_EXCEPTIONAL)
+ */
+void set_fd_event_options(fd_event *event, int options);
@@ -2,15 +2,23 @@
 
 #include <stdlib.h>
 
+#include "rastautil.h"
 #include "rmemory.h"
 
 fifo_t *fifo_init(unsigned int max_size) {
-    fifo_t *fifo = rmalloc(sizeof(fifo_t));
+    // a power of two capacity lets positions wrap around without a division
+    unsigned int capacity = round_up_to_power_of_two(max_size);
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    fifo_t *fifo = rmalloc_tagged(RASTA_MEMORY_TAG_FIFO, sizeof(fifo_t));
 
     fifo->size = 0;
     fifo->max_size = max_size;
-    fifo->head = NULL;
-    fifo->tail = NULL;
+    fifo->capacity = capacity;
+    fifo->head = 0;
+    fifo->elements = rmalloc_tagged(RASTA_MEMORY_TAG_FIFO, capacity * sizeof(void *));
 
     return fifo;
 }
@@ -18,22 +26,27 @@ fifo_t *fifo_init(unsigned int max_size) {
 void *fifo_pop(fifo_t *fifo) {
     void *res = NULL;
 
-    if (fifo->size > 0 && fifo->head != NULL && fifo->tail != NULL) {
-        struct fifo_element *element = fifo->head;
-        res = element->data;
-        fifo->head = fifo->head->next;
-
-        if (fifo->size == 1) {
-            fifo->tail = NULL;
-        }
-
-        rfree(element);
+    if (fifo->size > 0) {
+        res = fifo->elements[fifo->head & (fifo->capacity - 1)];
+        fifo->head++;
         fifo->size--;
     }
 
     return res;
 }
 
+void *fifo_peek(fifo_t *fifo) {
+    return fifo_get(fifo, 0);
+}
+
+void *fifo_get(fifo_t *fifo, unsigned int index) {
+    if (index >= fifo->size) {
+        return NULL;
+    }
+
+    return fifo->elements[(fifo->head + index) & (fifo->capacity - 1)];
+}
+
 int fifo_push(fifo_t *fifo, void *element) {
     if (element == NULL) {
         return 0;
@@ -43,18 +56,7 @@ int fifo_push(fifo_t *fifo, void *element) {
         return 0;
     }
 
-    struct fifo_element *new_entry = rmalloc(sizeof(struct fifo_element));
-    new_entry->data = element;
-    new_entry->next = NULL;
-
-    if (fifo->size == 0) {
-        fifo->head = new_entry;
-        fifo->tail = fifo->head;
-    } else {
-        fifo->tail->next = new_entry;
-        fifo->tail = new_entry;
-    }
-
+    fifo->elements[(fifo->head + fifo->size) & (fifo->capacity - 1)] = element;
     fifo->size++;
     return 1;
 }
@@ -71,10 +73,7 @@ int fifo_full(fifo_t *fifo) {
 
 void fifo_destroy(fifo_t **fifo) {
     if (*fifo != NULL) {
-        for (unsigned int i = 0; i < (*fifo)->size; ++i) {
-            fifo_pop(*fifo);
-        }
-
+        rfree((*fifo)->elements);
         rfree(*fifo);
     }
     *fifo = NULL;
@@ -1,21 +1,7 @@
 #pragma once
 
 /**
- * Representation of an element in the FIFO
- */
-struct fifo_element {
-    /**
-     * The data
-     */
-    void *data;
-    /**
-     * The pointer to the next FIFO element.
-     */
-    struct fifo_element *next;
-};
-
-/**
- * Representation of a simple FIFO data structure.
+ * Representation of a simple FIFO data structure, implemented as a ring buffer of element pointers.
  */
 typedef struct {
     /**
@@ -27,19 +13,23 @@ typedef struct {
      */
     unsigned int max_size;
     /**
-     * The first (oldest) element of the FIFO
+     * The amount of slots in the ring buffer, the smallest power of two >= max_size
+     */
+    unsigned int capacity;
+    /**
+     * The position of the first (oldest) element, the slot is head & (capacity - 1)
      */
-    struct fifo_element *head;
+    unsigned int head;
     /**
-     * The last (newest) element in the FIFO
+     * The slots of the ring buffer
      */
-    struct fifo_element *tail;
+    void **elements;
 } fifo_t;
 
 /**
  * Initializes an empty FIFO with given maximum amount of elements.
  * @param max_size maximum amount of elements in the queue
- * @return an initialized FIFO
+ * @return an initialized FIFO, NULL if max_size is larger than the largest power of two of an unsigned int
  */
 fifo_t *fifo_init(unsigned int max_size);
 
@@ -57,6 +47,21 @@ void fifo_destroy(fifo_t **fifo);
  */
 void *fifo_pop(fifo_t *fifo);
 
+/**
+ * Retrieves the first (oldest) element from the FIFO without removing it.
+ * @param fifo the FIFO to use
+ * @return the data of the first element or NULL if the FIFO is empty
+ */
+void *fifo_peek(fifo_t *fifo);
+
+/**
+ * Retrieves an element from the FIFO without removing it, can be used to iterate over the FIFO.
+ * @param fifo the FIFO to use
+ * @param index the position of the element, 0 is the first (oldest) element
+ * @return the data of the element or NULL if index is not smaller than the amount of elements
+ */
+void *fifo_get(fifo_t *fifo, unsigned int index);
+
 /**
  * Adds an element to the end of the FIFO. If the FIFO is full, nothing is done.
  * @param fifo the FIFO to use
@@ -0,0 +1,77 @@
+#include "mpsc_queue.h"
+
+#include <limits.h>
+
+#include "rastautil.h"
+#include "rmemory.h"
+
+mpsc_queue_t *mpsc_queue_init(size_t min_capacity) {
+    size_t capacity = min_capacity <= UINT_MAX ? round_up_to_power_of_two((unsigned int)min_capacity) : 0;
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    mpsc_queue_t *queue = rmalloc(sizeof(mpsc_queue_t));
+    queue->capacity = capacity;
+    queue->slots = rmalloc(capacity * sizeof(struct mpsc_queue_slot));
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&queue->slots[i].sequence, i);
+        queue->slots[i].data = NULL;
+    }
+    atomic_init(&queue->head, 0);
+    queue->tail = 0;
+
+    return queue;
+}
+
+void mpsc_queue_destroy(mpsc_queue_t **queue) {
+    if (*queue != NULL) {
+        rfree((*queue)->slots);
+        rfree(*queue);
+    }
+    *queue = NULL;
+}
+
+bool mpsc_queue_push(mpsc_queue_t *queue, void *element) {
+    if (element == NULL) {
+        return false;
+    }
+
+    size_t pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    for (;;) {
+        struct mpsc_queue_slot *slot = &queue->slots[pos & (queue->capacity - 1)];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (sequence == pos) {
+            // the slot is free, try to claim the position
+            if (atomic_compare_exchange_weak_explicit(&queue->head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                slot->data = element;
+                // publish the data to the consumer
+                atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+                return true;
+            }
+            // another producer claimed the position, pos has been updated by the failed exchange
+        } else if ((ptrdiff_t)(sequence - pos) < 0) {
+            // the slot still holds data from the previous round, the queue is full
+            return false;
+        } else {
+            // another producer already claimed the position
+            pos = atomic_load_explicit(&queue->head, memory_order_relaxed);
+        }
+    }
+}
+
+void *mpsc_queue_pop(mpsc_queue_t *queue) {
+    struct mpsc_queue_slot *slot = &queue->slots[queue->tail & (queue->capacity - 1)];
+    size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if (sequence != queue->tail + 1) {
+        // empty, or the producer that claimed the slot has not published it yet
+        return NULL;
+    }
+
+    void *res = slot->data;
+    slot->data = NULL;
+    // hand the slot to the producers of the next round
+    atomic_store_explicit(&slot->sequence, queue->tail + queue->capacity, memory_order_release);
+    queue->tail++;
+    return res;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * A slot in the MPSC queue
+ */
+struct mpsc_queue_slot {
+    /**
+     * The position the slot is ready for: equal to the write position if it can be written,
+     * write position + 1 if it holds data for the reader
+     */
+    atomic_size_t sequence;
+    /**
+     * The data
+     */
+    void *data;
+};
+
+/**
+ * Bounded lock-free queue with multiple producers and a single consumer.
+ * Producers may push from any thread, only one thread (the event loop) may pop.
+ */
+typedef struct {
+    /**
+     * The amount of slots, always a power of two
+     */
+    size_t capacity;
+    /**
+     * The next position to write to, shared by all producers
+     */
+    atomic_size_t head;
+    /**
+     * The next position to read from, only used by the consumer
+     */
+    size_t tail;
+    /**
+     * The slots of the ring buffer
+     */
+    struct mpsc_queue_slot *slots;
+} mpsc_queue_t;
+
+/**
+ * Initializes an empty queue.
+ * @param min_capacity the minimum amount of elements in the queue, rounded up to the next power of two
+ * @return an initialized queue, NULL if min_capacity is larger than the largest power of two of an unsigned int
+ */
+mpsc_queue_t *mpsc_queue_init(size_t min_capacity);
+
+/**
+ * Destroys the given queue.
+ * Note: the data of the elements that are still inside is NOT freed
+ * @param queue the queue to free
+ */
+void mpsc_queue_destroy(mpsc_queue_t **queue);
+
+/**
+ * Adds an element to the end of the queue. Can be called from any thread.
+ * @param queue the queue to use
+ * @param element the data to insert
+ * @return true if the element was added, false if the queue is full
+ */
+bool mpsc_queue_push(mpsc_queue_t *queue, void *element);
+
+/**
+ * Retrieves the first (oldest) element from the queue and removes it from the queue.
+ * Must only be called from the consuming thread.
+ * @param queue the queue to use
+ * @return the data of the first element or NULL if the queue is empty
+ */
+void *mpsc_queue_pop(mpsc_queue_t *queue);
@@ -148,6 +148,16 @@ int rasta_blake2b_init(rasta_blake2b_ctx *ctx, size_t outlen,
     return 0;
 }
 
+// Compress the buffered key block ahead of the message.
+
+void rasta_blake2b_absorb_key(rasta_blake2b_ctx *ctx) {
+    if (ctx->c == 128 && ctx->t[0] == 0 && ctx->t[1] == 0) {
+        ctx->t[0] = 128;
+        blake2b_compress(ctx, 0);
+        ctx->c = 0;
+    }
+}
+
 // Add "inlen" bytes from "in" into the hash.
 
 void rasta_blake2b_update(rasta_blake2b_ctx *ctx,
@@ -57,6 +57,14 @@ typedef struct {
 int rasta_blake2b_init(rasta_blake2b_ctx *ctx, size_t outlen,
                        const void *key, size_t keylen);
 
+/**
+ * Compresses the key block that is buffered by rasta_blake2b_init, so that the context can be copied and used as the
+ * starting point for all messages with the same key. Only valid for keyed contexts that are updated with at least
+ * one more byte before rasta_blake2b_final is called.
+ * @param ctx the hashing context directly after rasta_blake2b_init
+ */
+void rasta_blake2b_absorb_key(rasta_blake2b_ctx *ctx);
+
 /**
  * Add @p inlen bytes from @p in into the hash.
  * @param ctx hashing context
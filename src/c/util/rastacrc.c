@@ -1,5 +1,27 @@
 #include "rastacrc.h"
 
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rastakernels.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RASTA_CRC32C_HW
+#define RASTA_CRC_FOLD
+#define CRC32C_TARGET __attribute__((target("sse4.2")))
+#define CRC_FOLD_TARGET __attribute__((target("pclmul,ssse3")))
+#elif defined(__aarch64__) && defined(__linux__) && (defined(__GNUC__) || defined(__clang__))
+#include <arm_acle.h>
+#define RASTA_CRC32C_HW
+#ifdef __clang__
+#define CRC32C_TARGET __attribute__((target("crc")))
+#else
+#define CRC32C_TARGET __attribute__((target("+crc")))
+#endif
+#endif
+
 /**
  * reflects the lower @p n bits
  * @param crc_in the crc input value
@@ -135,7 +157,376 @@ void crc_generate_table(struct crc_options *options) {
 
     options->is_table_generated = 1;
 }
+
+/**
+ * CRC engine for one of the options of 6.3.6, with slicing-by-8 tables and the constants for folding
+ * with carry-less multiplication. The engines are generated once and shared by all crc_options.
+ */
+struct crc_engine {
+    unsigned short width;
+    unsigned long polynom;
+    int reflected;
+
+    /**
+     * table[0] is the usual byte table, table[k] advances a byte over k more zero bytes
+     */
+    uint32_t table[8][256];
+
+    /**
+     * constants for folding a 128 bit block over the next one, in the lanes they are multiplied with
+     */
+    uint64_t fold_lane0;
+    uint64_t fold_lane1;
+
+    /**
+     * the kernel that updates the register of the engine, bound when the engines are generated
+     */
+    uint32_t (*kernel)(const struct crc_engine *engine, uint32_t crc, const unsigned char *bytes, size_t length);
+    const char *kernel_name;
+};
+
+// the options b, c, d and e
+#define CRC_ENGINE_COUNT 4
+
+static struct crc_engine crc_engines[CRC_ENGINE_COUNT];
+static pthread_once_t crc_engines_once = PTHREAD_ONCE_INIT;
+
+// inputs shorter than this are not worth folding
+#define CRC_FOLD_MIN_LENGTH 64
+
+/**
+ * calculates x^n mod the polynom, bit i is the coefficient of x^i
+ */
+static uint64_t crc_xpow_mod(unsigned short width, unsigned long polynom, unsigned int n) {
+    uint64_t result = 1;
+    for (unsigned int i = 0; i < n; i++) {
+        result <<= 1;
+        if (result & ((uint64_t)1 << width)) {
+            result ^= ((uint64_t)1 << width) | polynom;
+        }
+    }
+    return result;
+}
+
+static uint64_t reflect64(uint64_t v) {
+    return ((uint64_t)reflect((unsigned long)(v & 0xFFFFFFFF), 32) << 32) | reflect((unsigned long)(v >> 32), 32);
+}
+
+static void crc_engine_init(struct crc_engine *engine, struct crc_options options) {
+    engine->width = options.width;
+    engine->polynom = options.polynom;
+    engine->reflected = options.refin;
+
+    uint32_t mask = (uint32_t)options.crc_mask;
+    uint32_t polynom_reflected = (uint32_t)reflect(options.polynom, options.width);
+    for (uint32_t b = 0; b < 256; b++) {
+        uint32_t crc;
+        if (engine->reflected) {
+            crc = b;
+            for (int j = 0; j < 8; j++) {
+                crc = (crc & 1) ? (crc >> 1) ^ polynom_reflected : crc >> 1;
+            }
+        } else {
+            crc = b << (options.width - 8);
+            for (int j = 0; j < 8; j++) {
+                crc = (crc & (uint32_t)options.crc_high_bit) ? (crc << 1) ^ (uint32_t)options.polynom : crc << 1;
+            }
+        }
+        engine->table[0][b] = crc & mask;
+    }
+
+    for (int k = 1; k < 8; k++) {
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t crc = engine->table[k - 1][b];
+            if (engine->reflected) {
+                engine->table[k][b] = (crc >> 8) ^ engine->table[0][crc & 0xff];
+            } else {
+                engine->table[k][b] = ((crc << 8) ^ engine->table[0][crc >> 24]) & mask;
+            }
+        }
+    }
+
+    // a block A = A_hi * x^64 + A_lo is folded over the 128 bits of the next block by multiplying with x^192 and x^128.
+    // Reflected input is loaded bit reversed, which shifts the product of two reversed values by one bit.
+    if (engine->reflected) {
+        engine->fold_lane0 = reflect64(crc_xpow_mod(options.width, options.polynom, 191));
+        engine->fold_lane1 = reflect64(crc_xpow_mod(options.width, options.polynom, 127));
+    } else {
+        engine->fold_lane0 = crc_xpow_mod(options.width, options.polynom, 128);
+        engine->fold_lane1 = crc_xpow_mod(options.width, options.polynom, 192);
+    }
+}
+
+static uint32_t crc_engine_update(const struct crc_engine *engine, uint32_t crc, const unsigned char *bytes, size_t length) {
+    if (engine->reflected) {
+        while (length >= 8) {
+            uint32_t a = crc ^ ((uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24);
+            crc = engine->table[7][a & 0xff] ^ engine->table[6][(a >> 8) & 0xff] ^
+                  engine->table[5][(a >> 16) & 0xff] ^ engine->table[4][a >> 24] ^
+                  engine->table[3][bytes[4]] ^ engine->table[2][bytes[5]] ^
+                  engine->table[1][bytes[6]] ^ engine->table[0][bytes[7]];
+            bytes += 8;
+            length -= 8;
+        }
+        while (length--) {
+            crc = (crc >> 8) ^ engine->table[0][(crc ^ *bytes++) & 0xff];
+        }
+    } else {
+        // only used for a width of 32
+        while (length >= 8) {
+            uint32_t a = crc ^ ((uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | (uint32_t)bytes[3]);
+            crc = engine->table[7][a >> 24] ^ engine->table[6][(a >> 16) & 0xff] ^
+                  engine->table[5][(a >> 8) & 0xff] ^ engine->table[4][a & 0xff] ^
+                  engine->table[3][bytes[4]] ^ engine->table[2][bytes[5]] ^
+                  engine->table[1][bytes[6]] ^ engine->table[0][bytes[7]];
+            bytes += 8;
+            length -= 8;
+        }
+        while (length--) {
+            crc = (crc << 8) ^ engine->table[0][(crc >> 24) ^ *bytes++];
+        }
+    }
+    return crc;
+}
+
+#ifdef RASTA_CRC_FOLD
+/**
+ * folds the input with carry-less multiplication until one 128 bit block is left, which is finished with the tables
+ * @param length at least CRC_FOLD_MIN_LENGTH
+ */
+CRC_FOLD_TARGET static uint32_t crc_engine_fold(const struct crc_engine *engine, uint32_t crc, const unsigned char *bytes, size_t length) {
+    const __m128i byte_swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i constants = _mm_set_epi64x((long long)engine->fold_lane1, (long long)engine->fold_lane0);
+
+    // the register of the table algorithm corresponds to the first bits of the message
+    unsigned char block[16];
+    memcpy(block, bytes, sizeof(block));
+    for (int i = 0; i < engine->width / 8; i++) {
+        block[i] ^= (unsigned char)(engine->reflected ? crc >> (8 * i) : crc >> (engine->width - 8 - 8 * i));
+    }
+
+    __m128i x = _mm_loadu_si128((const __m128i *)block);
+    if (!engine->reflected) {
+        x = _mm_shuffle_epi8(x, byte_swap);
+    }
+    bytes += 16;
+    length -= 16;
+
+    while (length >= 16) {
+        __m128i next = _mm_loadu_si128((const __m128i *)bytes);
+        if (!engine->reflected) {
+            next = _mm_shuffle_epi8(next, byte_swap);
+        }
+        x = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, constants, 0x00), _mm_clmulepi64_si128(x, constants, 0x11)), next);
+        bytes += 16;
+        length -= 16;
+    }
+
+    if (!engine->reflected) {
+        x = _mm_shuffle_epi8(x, byte_swap);
+    }
+    _mm_storeu_si128((__m128i *)block, x);
+
+    crc = crc_engine_update(engine, 0, block, sizeof(block));
+    return crc_engine_update(engine, crc, bytes, length);
+}
+#endif
+
+#ifdef RASTA_CRC32C_HW
+
+// the polynom of option c (Castagnoli), the one the CRC32C instructions of SSE4.2 and ARMv8 implement
+#define CRC32C_POLYNOM 0x1EDC6F41
+#define CRC32C_POLYNOM_REFLECTED 0x82F63B78
+
+// inputs of at least 3 blocks are processed as 3 interleaved streams, to hide the latency of the instruction
+#define CRC32C_STREAM_BLOCK 256
+
+// crc32c_shift_table[k][v] is the CRC register (v << 8k) shifted over CRC32C_STREAM_BLOCK zero bytes
+static uint32_t crc32c_shift_table[4][256];
+
+/**
+ * multiplies two polynomials modulo the reflected CRC32C polynom, x^0 is the highest bit
+ */
+static uint32_t crc32c_multmodp(uint32_t a, uint32_t b) {
+    uint32_t m = (uint32_t)1 << 31;
+    uint32_t p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) {
+                break;
+            }
+        }
+        m >>= 1;
+        b = b & 1 ? (b >> 1) ^ CRC32C_POLYNOM_REFLECTED : b >> 1;
+    }
+    return p;
+}
+
+static void crc32c_hw_init(void) {
+    // x^(8 * CRC32C_STREAM_BLOCK), by squaring x^1 (log2(8 * CRC32C_STREAM_BLOCK) = 11 times)
+    uint32_t shift = (uint32_t)1 << 30;
+    for (int i = 0; i < 11; i++) {
+        shift = crc32c_multmodp(shift, shift);
+    }
+
+    for (uint32_t k = 0; k < 4; k++) {
+        for (uint32_t v = 0; v < 256; v++) {
+            crc32c_shift_table[k][v] = crc32c_multmodp(shift, v << (8 * k));
+        }
+    }
+}
+
+static uint32_t crc32c_shift_block(uint32_t crc) {
+    return crc32c_shift_table[0][crc & 0xff] ^ crc32c_shift_table[1][(crc >> 8) & 0xff] ^
+           crc32c_shift_table[2][(crc >> 16) & 0xff] ^ crc32c_shift_table[3][crc >> 24];
+}
+
+CRC32C_TARGET static uint32_t crc32c_hw_u64(uint32_t crc, const unsigned char *bytes) {
+    uint64_t v;
+    memcpy(&v, bytes, sizeof(v));
+#if defined(__x86_64__)
+    return (uint32_t)_mm_crc32_u64(crc, v);
+#else
+    return __crc32cd(crc, v);
+#endif
+}
+
+CRC32C_TARGET static uint32_t crc32c_hw_u8(uint32_t crc, unsigned char byte) {
+#if defined(__x86_64__)
+    return _mm_crc32_u8(crc, byte);
+#else
+    return __crc32cb(crc, byte);
+#endif
+}
+
+/**
+ * updates a reflected CRC32C register without pre- and post-conditioning using the CRC32C instruction
+ */
+CRC32C_TARGET static uint32_t crc32c_hw(uint32_t crc, const unsigned char *bytes, size_t length) {
+    while (length >= 3 * CRC32C_STREAM_BLOCK) {
+        uint32_t crc1 = 0;
+        uint32_t crc2 = 0;
+        for (size_t i = 0; i < CRC32C_STREAM_BLOCK; i += 8) {
+            crc = crc32c_hw_u64(crc, &bytes[i]);
+            crc1 = crc32c_hw_u64(crc1, &bytes[CRC32C_STREAM_BLOCK + i]);
+            crc2 = crc32c_hw_u64(crc2, &bytes[2 * CRC32C_STREAM_BLOCK + i]);
+        }
+        // the register of a stream is shifted over the bytes of the next one and combined with it
+        crc = crc32c_shift_block(crc) ^ crc1;
+        crc = crc32c_shift_block(crc) ^ crc2;
+
+        bytes += 3 * CRC32C_STREAM_BLOCK;
+        length -= 3 * CRC32C_STREAM_BLOCK;
+    }
+
+    while (length >= 8) {
+        crc = crc32c_hw_u64(crc, bytes);
+        bytes += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = crc32c_hw_u8(crc, *bytes++);
+    }
+    return crc;
+}
+
+#endif
+
+#ifdef RASTA_CRC_FOLD
+static uint32_t crc_fold_kernel(const struct crc_engine *engine, uint32_t crc, const unsigned char *bytes, size_t length) {
+    if (length < CRC_FOLD_MIN_LENGTH) {
+        return crc_engine_update(engine, crc, bytes, length);
+    }
+    return crc_engine_fold(engine, crc, bytes, length);
+}
+#endif
+
+#ifdef RASTA_CRC32C_HW
+static uint32_t crc32c_kernel(const struct crc_engine *engine, uint32_t crc, const unsigned char *bytes, size_t length) {
+    (void)engine;
+    return crc32c_hw(crc, bytes, length);
+}
+#endif
+
+/**
+ * the kernels of the engines, from the fastest to the slowest
+ */
+static const struct {
+    const char *name;
+    unsigned int required_features;
+    /**
+     * the polynom the kernel is restricted to, 0 for all polynoms
+     */
+    unsigned long polynom;
+    uint32_t (*kernel)(const struct crc_engine *engine, uint32_t crc, const unsigned char *bytes, size_t length);
+} crc_kernels[] = {
+#ifdef RASTA_CRC32C_HW
+    {"crc32c instruction", RASTA_CPU_CRC32C, CRC32C_POLYNOM, crc32c_kernel},
+#endif
+#ifdef RASTA_CRC_FOLD
+    {"pclmulqdq folding", RASTA_CPU_CLMUL, 0, crc_fold_kernel},
+#endif
+    {"slicing-by-8", 0, 0, crc_engine_update},
+};
+
+static void crc_engines_init(void) {
+    crc_engine_init(&crc_engines[0], crc_init_opt_b());
+    crc_engine_init(&crc_engines[1], crc_init_opt_c());
+    crc_engine_init(&crc_engines[2], crc_init_opt_d());
+    crc_engine_init(&crc_engines[3], crc_init_opt_e());
+
+#ifdef RASTA_CRC32C_HW
+    if (rasta_cpu_supports(RASTA_CPU_CRC32C)) {
+        crc32c_hw_init();
+    }
+#endif
+
+    for (int i = 0; i < CRC_ENGINE_COUNT; i++) {
+        for (size_t k = 0; k < sizeof(crc_kernels) / sizeof(crc_kernels[0]); k++) {
+            if (rasta_cpu_supports(crc_kernels[k].required_features) &&
+                (crc_kernels[k].polynom == 0 || crc_kernels[k].polynom == crc_engines[i].polynom)) {
+                crc_engines[i].kernel = crc_kernels[k].kernel;
+                crc_engines[i].kernel_name = crc_kernels[k].name;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * finds the shared engine for the @p options
+ * @return the engine or NULL if the options are not one of the options of 6.3.6
+ */
+static const struct crc_engine *crc_find_engine(struct crc_options *options) {
+    if (options->refin != options->refout) {
+        return NULL;
+    }
+
+    pthread_once(&crc_engines_once, crc_engines_init);
+    for (int i = 0; i < CRC_ENGINE_COUNT; i++) {
+        if (crc_engines[i].width == options->width && crc_engines[i].polynom == options->polynom &&
+            crc_engines[i].reflected == options->refin) {
+            return &crc_engines[i];
+        }
+    }
+    return NULL;
+}
+
+const char *crc_kernel_name(struct crc_options *options) {
+    const struct crc_engine *engine = crc_find_engine(options);
+    return engine != NULL ? engine->kernel_name : "lookup table";
+}
+
 unsigned long crc_calculate(struct crc_options *options, struct RastaByteArray data) {
+    const struct crc_engine *engine = crc_find_engine(options);
+    if (engine != NULL) {
+        uint32_t crc = (uint32_t)(options->refin ? reflect(options->initial_optimized, options->width) : options->initial_optimized);
+        crc = engine->kernel(engine, crc, data.bytes, data.length);
+        return (crc ^ options->final_xor) & options->crc_mask;
+    }
+
+    // other options use the table in the options
     if (!options->is_table_generated) {
         crc_generate_table(options);
     }
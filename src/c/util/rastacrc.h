@@ -2,6 +2,10 @@
  * This module provides functions to calculate the CRC checksum of a bytearray.
  * The CRC options as specified in 6.3.6 can be generated using the functions
  * crc_init_opt_b, crc_init_opt_c, crc_init_opt_d, crc_init_opt_e
+ * For these options the checksum is calculated with slicing-by-8 tables that are generated once and shared, and
+ * long inputs are folded with carry-less multiplication (PCLMULQDQ) if the CPU supports it. Option c (CRC32C) is
+ * calculated with the CRC32C instruction if the CPU supports it (SSE4.2 or the ARMv8 CRC extension).
+ * Other options use the lookup table in their crc_options.
  *
  * Example:
  *
@@ -64,11 +68,18 @@ struct crc_options crc_init_opt_d();
 struct crc_options crc_init_opt_e();
 
 /**
- * generate the crc lookup table for the given @p options
+ * generate the crc lookup table for the given @p options, only needed for options other than the ones of 6.3.6
  * @param options the options which the table is generated for
  */
 void crc_generate_table(struct crc_options *options);
 
+/**
+ * gets the name of the kernel that calculates the crc for the given @p options
+ * @param options the options
+ * @return the name of the kernel
+ */
+const char *crc_kernel_name(struct crc_options *options);
+
 /**
  * calculates the crc of the given @p data with the given @p options
  * if the crc lookup table has not been generated yet, it will be generated first.
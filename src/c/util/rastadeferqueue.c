@@ -4,6 +4,24 @@
 
 #include "rmemory.h"
 
+#define OCCUPIED_BITS 64
+
+static unsigned int slot_of(struct defer_queue *queue, unsigned long seq_nr) {
+    return (unsigned int)(seq_nr & (queue->capacity - 1));
+}
+
+static int slot_occupied(struct defer_queue *queue, unsigned int slot) {
+    return (queue->occupied[slot / OCCUPIED_BITS] >> (slot % OCCUPIED_BITS)) & 1;
+}
+
+static void set_slot_occupied(struct defer_queue *queue, unsigned int slot, int occupied) {
+    if (occupied) {
+        queue->occupied[slot / OCCUPIED_BITS] |= (uint64_t)1 << (slot % OCCUPIED_BITS);
+    } else {
+        queue->occupied[slot / OCCUPIED_BITS] &= ~((uint64_t)1 << (slot % OCCUPIED_BITS));
+    }
+}
+
 /**
  * finds the index of a given element inside the given queue.
  * The sequence_number is used as the unique identifier
@@ -12,35 +30,21 @@
  * @return -1 if there is no element with the specified @p seq_nr, index of the element otherwise
  */
 int find_index(struct defer_queue *queue, unsigned long seq_nr) {
-    unsigned int index = 0;
-
-    // naive implementation of search. performance shouldn't be an issue as the amount of messages in the queue is small
-    while (index < queue->count && queue->elements[index].packet.sequence_number != seq_nr)
-        ++index;
-
-    return (index == queue->count ? -1 : (int)index);
-}
-
-int cmpfkt(const void *a, const void *b) {
-    long long a_ts = (long long)((struct rasta_redundancy_packet_wrapper *)a)->received_timestamp;
-    long long b_ts = (long long)((struct rasta_redundancy_packet_wrapper *)b)->received_timestamp;
-
-    return (int)(a_ts - b_ts);
-}
+    unsigned int slot = slot_of(queue, seq_nr);
+    if (!slot_occupied(queue, slot)) {
+        return -1;
+    }
 
-/**
- * sorts the elements in the queue in ascending time (first element has oldest timestamp)
- * @param queue the queue that will be sorted
- */
-void sort(struct defer_queue *queue) {
-    qsort(queue->elements, queue->count, sizeof(struct rasta_redundancy_packet_wrapper), cmpfkt);
+    // the slot might be used by a sequence number from another round of the ring
+    unsigned int index = queue->slots[slot];
+    return (queue->elements[index].packet.sequence_number == seq_nr ? (int)index : -1);
 }
 
-struct defer_queue deferqueue_init(unsigned int n_max) {
+struct defer_queue deferqueue_init(unsigned int n_max, unsigned int seq_window) {
     struct defer_queue queue;
 
     // allocate the array
-    queue.elements = rmalloc(n_max * sizeof(struct rasta_redundancy_packet_wrapper));
+    queue.elements = rmalloc_tagged(RASTA_MEMORY_TAG_DEFERQUEUE, n_max * sizeof(struct rasta_redundancy_packet_wrapper));
 
     // set count to 0
     queue.count = 0;
@@ -48,6 +52,15 @@ struct defer_queue deferqueue_init(unsigned int n_max) {
     // set max count
     queue.max_count = n_max;
 
+    // every sequence number in the window gets its own slot
+    queue.capacity = OCCUPIED_BITS;
+    while (queue.capacity < seq_window) {
+        queue.capacity <<= 1;
+    }
+    queue.slots = rmalloc_tagged(RASTA_MEMORY_TAG_DEFERQUEUE, queue.capacity * sizeof(unsigned int));
+    queue.occupied = rmalloc_tagged(RASTA_MEMORY_TAG_DEFERQUEUE, queue.capacity / OCCUPIED_BITS * sizeof(uint64_t));
+    rmemset(queue.occupied, 0, queue.capacity / OCCUPIED_BITS * sizeof(uint64_t));
+
     return queue;
 }
 
@@ -64,18 +77,24 @@ int deferqueue_add(struct defer_queue *queue, struct RastaRedundancyPacket packe
         return 0;
     }
 
+    unsigned int slot = slot_of(queue, packet.sequence_number);
+    if (slot_occupied(queue, slot)) {
+        // already in the queue or the sequence number is outside of the window
+        return 0;
+    }
+
     struct rasta_redundancy_packet_wrapper element;
     element.packet = packet;
     element.received_timestamp = recv_ts;
 
     // add element to the end
     queue->elements[queue->count] = element;
+    queue->slots[slot] = queue->count;
+    set_slot_occupied(queue, slot, 1);
 
     // increase count
     queue->count = queue->count + 1;
 
-    // sort array
-    sort(queue);
     return 1;
 }
 
@@ -86,18 +105,18 @@ void deferqueue_remove(struct defer_queue *queue, unsigned long seq_nr) {
         return;
     }
 
+    set_slot_occupied(queue, slot_of(queue, seq_nr), 0);
+
     if ((unsigned int)index != (queue->count - 1)) {
         // element to delete isn't at the last position
         // to be able to add the next element to the last position without overriding something
         // the currently last element is moved to the index where the element to delete is located
         queue->elements[index] = queue->elements[queue->count - 1];
+        queue->slots[slot_of(queue, queue->elements[index].packet.sequence_number)] = (unsigned int)index;
     }
 
     // decrease counter
     queue->count--;
-
-    // sort the array
-    sort(queue);
 }
 
 int deferqueue_contains(struct defer_queue *queue, unsigned long seq_nr) {
@@ -108,9 +127,12 @@ int deferqueue_contains(struct defer_queue *queue, unsigned long seq_nr) {
 
 void deferqueue_destroy(struct defer_queue *queue) {
     rfree(queue->elements);
+    rfree(queue->slots);
+    rfree(queue->occupied);
 
     queue->count = 0;
     queue->max_count = 0;
+    queue->capacity = 0;
 }
 
 int deferqueue_smallest_seqnr(struct defer_queue *queue) {
@@ -120,8 +142,8 @@ int deferqueue_smallest_seqnr(struct defer_queue *queue) {
     // largest number possible
     unsigned long smallest = 0xFFFFFFFF;
 
-    // naive implementation of search. performance shouldn't be an issue as the amount of messages in the queue is small
-    for (unsigned int i = 0; i < queue->max_count; ++i) {
+    // only used when the defer timeout expires, so a search over the elements is sufficient
+    for (unsigned int i = 0; i < queue->count; ++i) {
         if (queue->elements[i].packet.sequence_number < smallest) {
             smallest = queue->elements[i].packet.sequence_number;
             index = i;
@@ -157,6 +179,9 @@ unsigned long deferqueue_get_ts(struct defer_queue *queue, unsigned long seq_nr)
 }
 
 void deferqueue_clear(struct defer_queue *queue) {
-    // just set count to 0, elements that are in the queue will be overridden
+    // release the slots, elements that are in the queue will be overridden
+    for (unsigned int i = 0; i < queue->count; i++) {
+        set_slot_occupied(queue, slot_of(queue, queue->elements[i].packet.sequence_number), 0);
+    }
     queue->count = 0;
 }
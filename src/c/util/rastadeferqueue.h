@@ -1,11 +1,14 @@
 /**
  * a simple implementation of the defer queue which is used in the redundancy layer
- * This implementation uses an arraylist for storage of the elements
+ * The elements are kept in an arraylist, a ring of slots indexed by the sequence number maps to them,
+ * so adding, looking up and removing an element does not depend on the amount of elements in the queue.
  * the sequence number is used as an unique identifier
  */
 
 #pragma once
 
+#include <stdint.h>
+
 #include "rastamodule.h"
 
 /**
@@ -35,14 +38,31 @@ struct defer_queue {
      * maximum number of elements in the queue
      */
     unsigned int max_count;
+
+    /**
+     * the amount of slots in the ring, a power of two, the slot of a sequence number is seq_nr & (capacity - 1)
+     */
+    unsigned int capacity;
+
+    /**
+     * the index in elements for every slot of the ring
+     */
+    unsigned int *slots;
+
+    /**
+     * bitmap of the slots of the ring that are in use
+     */
+    uint64_t *occupied;
 };
 
 /**
  * initializes an empty queue with the given amount of elements
  * @param n_max maximum amount of elements the queue can hold
+ * @param seq_window the amount of consecutive sequence numbers that can be in the queue at the same time,
+ * elements whose sequence numbers are further apart can collide and might not be added
  * @return an initialized defer queue
  */
-struct defer_queue deferqueue_init(unsigned int n_max);
+struct defer_queue deferqueue_init(unsigned int n_max, unsigned int seq_window);
 
 /**
  * frees the memory for all elements
@@ -56,6 +76,7 @@ void deferqueue_destroy(struct defer_queue *queue);
  * @param queue the queue where the @p element will be added
  * @param packet the element that will be added
  * @param recv_ts the timestamp when the @p element was received
+ * @return 1 if the element was added, 0 if the queue is full or the slot of the sequence number is in use
  */
 int deferqueue_add(struct defer_queue *queue, struct RastaRedundancyPacket packet, unsigned long recv_ts);
 
@@ -21,6 +21,8 @@ void rasta_md4_set_key(rasta_hashing_context_t *context, MD4_u32plus a, MD4_u32p
 
     hostLongToLe(d, buffer);
     rmemcpy(&context->key.bytes[12], buffer, 4 * sizeof(unsigned char));
+
+    rasta_hashing_context_prepare(context);
 }
 
 void rasta_set_hash_key_variable(rasta_hashing_context_t *context, const char *key, size_t key_length) {
@@ -30,6 +32,8 @@ void rasta_set_hash_key_variable(rasta_hashing_context_t *context, const char *k
     allocateRastaByteArray(&context->key, key_length);
     memcpy(context->key.bytes, key, key_length);
     context->key.length = key_length;
+
+    rasta_hashing_context_prepare(context);
 }
 
 MD4_CONTEXT rasta_get_md4_ctx_from_key(rasta_hashing_context_t *context) {
@@ -47,27 +51,109 @@ MD4_CONTEXT rasta_get_md4_ctx_from_key(rasta_hashing_context_t *context) {
     return md4InitContext(a, b, c, d);
 }
 
-void rasta_calculate_hash(struct RastaByteArray data, rasta_hashing_context_t *context, unsigned char *hash) {
-    MD4_CONTEXT md4_ctx;
-    if (!context->key.length) {
-        // should never happen
-        abort();
+static void rasta_hash_md4(struct RastaByteArray data, rasta_hashing_context_t *context, unsigned char *hash) {
+    MD4_CONTEXT md4_ctx = context->keyed_state.md4;
+    generateMD4WithVector(data.bytes, data.length, context->hash_length, &md4_ctx, hash);
+}
+
+static void rasta_hash_blake2b(struct RastaByteArray data, rasta_hashing_context_t *context, unsigned char *hash) {
+    if (context->hash_length == RASTA_CHECKSUM_NONE || context->hash_length > RASTA_CHECKSUM_16B || context->key.length > 64 || data.length == 0) {
+        // the prepared state only covers keyed hashes of non-empty data
+        generateBlake2(data.bytes, data.length, context->key.bytes, context->key.length, context->hash_length, hash);
+        return;
     }
+    rasta_blake2b_ctx blake_ctx = context->keyed_state.blake2b;
+    rasta_blake2b_update(&blake_ctx, data.bytes, data.length);
+    rasta_blake2b_final(&blake_ctx, hash);
+}
+
+static void rasta_hash_siphash(struct RastaByteArray data, rasta_hashing_context_t *context, unsigned char *hash) {
+    generateSiphash24WithState(data.bytes, data.length, &context->keyed_state.siphash, context->hash_length, hash);
+}
+
+static void rasta_hash_batch_md4(const struct RastaByteArray *data, unsigned int count, rasta_hashing_context_t *context, unsigned char *const *hashes) {
+    unsigned char *bytes[RASTA_HASH_BATCH_SIZE];
+    unsigned long lengths[RASTA_HASH_BATCH_SIZE];
+    for (unsigned int i = 0; i < count; i += RASTA_HASH_BATCH_SIZE) {
+        unsigned int n = count - i < RASTA_HASH_BATCH_SIZE ? count - i : RASTA_HASH_BATCH_SIZE;
+        for (unsigned int j = 0; j < n; j++) {
+            bytes[j] = data[i + j].bytes;
+            lengths[j] = data[i + j].length;
+        }
+        generateMD4Batch(bytes, lengths, n, context->hash_length, &context->keyed_state.md4, &hashes[i]);
+    }
+}
+
+static void rasta_hash_batch_single(const struct RastaByteArray *data, unsigned int count, rasta_hashing_context_t *context, unsigned char *const *hashes) {
+    for (unsigned int i = 0; i < count; i++) {
+        context->hash(data[i], context, hashes[i]);
+    }
+}
+
+void rasta_hashing_context_prepare(rasta_hashing_context_t *context) {
+    unsigned char siphash_key[16];
+
+    context->keyed_algorithm = context->algorithm;
+    context->keyed_hash_length = context->hash_length;
+
     switch (context->algorithm) {
-    case RASTA_ALGO_MD4:
-        md4_ctx = rasta_get_md4_ctx_from_key(context);
-        generateMD4WithVector(data.bytes, data.length, context->hash_length, &md4_ctx, hash);
-        break;
     case RASTA_ALGO_BLAKE2B:
-        generateBlake2(data.bytes, data.length, context->key.bytes, context->key.length, context->hash_length, hash);
+        context->hash = rasta_hash_blake2b;
+        context->hash_batch = rasta_hash_batch_single;
         break;
     case RASTA_ALGO_SIPHASH_2_4:
-        generateSiphash24(data.bytes, data.length, context->key.bytes, context->hash_length, hash);
+        context->hash = rasta_hash_siphash;
+        context->hash_batch = rasta_hash_batch_single;
         break;
     default:
         // just use MD4
-        md4_ctx = rasta_get_md4_ctx_from_key(context);
-        generateMD4WithVector(data.bytes, data.length, context->hash_length, &md4_ctx, hash);
+        context->hash = rasta_hash_md4;
+        context->hash_batch = rasta_hash_batch_md4;
+        break;
+    }
+
+    if (!context->key.length) {
+        return;
+    }
+
+    switch (context->algorithm) {
+    case RASTA_ALGO_BLAKE2B:
+        // a hash length that BLAKE2b cannot produce is left to generateBlake2
+        if (context->hash_length > 0 && context->hash_length <= RASTA_CHECKSUM_16B &&
+            rasta_blake2b_init(&context->keyed_state.blake2b, context->hash_length * 8, context->key.bytes, context->key.length) == 0) {
+            rasta_blake2b_absorb_key(&context->keyed_state.blake2b);
+        }
         break;
+    case RASTA_ALGO_SIPHASH_2_4:
+        // SipHash uses a 128 bit key, shorter keys are padded with zeros
+        rmemset(siphash_key, 0, sizeof(siphash_key));
+        rmemcpy(siphash_key, context->key.bytes, context->key.length < sizeof(siphash_key) ? context->key.length : sizeof(siphash_key));
+        rasta_siphash_init_state(&context->keyed_state.siphash, siphash_key);
+        break;
+    default:
+        context->keyed_state.md4 = rasta_get_md4_ctx_from_key(context);
+        break;
+    }
+}
+
+void rasta_calculate_hash(struct RastaByteArray data, rasta_hashing_context_t *context, unsigned char *hash) {
+    if (!context->key.length) {
+        // should never happen
+        abort();
+    }
+    if (context->keyed_algorithm != context->algorithm || context->keyed_hash_length != context->hash_length) {
+        rasta_hashing_context_prepare(context);
+    }
+    context->hash(data, context, hash);
+}
+
+void rasta_calculate_hash_batch(const struct RastaByteArray *data, unsigned int count, rasta_hashing_context_t *context, unsigned char *const *hashes) {
+    if (!context->key.length) {
+        // should never happen
+        abort();
+    }
+    if (context->keyed_algorithm != context->algorithm || context->keyed_hash_length != context->hash_length) {
+        rasta_hashing_context_prepare(context);
     }
+    context->hash_batch(data, count, context, hashes);
 }
@@ -5,6 +5,18 @@
 #include "rastasiphash24.h"
 #include "rastautil.h"
 
+struct rasta_hashing_ctx;
+
+/**
+ * A kernel that calculates the checksum of one message
+ */
+typedef void (*rasta_hash_kernel)(struct RastaByteArray data, struct rasta_hashing_ctx *context, unsigned char *hash);
+
+/**
+ * A kernel that calculates the checksums of several independent messages
+ */
+typedef void (*rasta_hash_batch_kernel)(const struct RastaByteArray *data, unsigned int count, struct rasta_hashing_ctx *context, unsigned char *const *hashes);
+
 typedef struct rasta_hashing_ctx {
     /**
      * The hashing algorithm
@@ -18,6 +30,24 @@ typedef struct rasta_hashing_ctx {
      * The key / iv for the hashing algorithm
      */
     struct RastaByteArray key;
+    /**
+     * The state of the hashing algorithm after the key has been applied, every hash starts from a copy of it
+     */
+    union {
+        MD4_CONTEXT md4;
+        rasta_blake2b_ctx blake2b;
+        rasta_siphash_state siphash;
+    } keyed_state;
+    /**
+     * The algorithm and hash length that the keyed state has been prepared for
+     */
+    rasta_hash_algorithm keyed_algorithm;
+    rasta_checksum_type keyed_hash_length;
+    /**
+     * The kernels of the algorithm, bound together with the keyed state
+     */
+    rasta_hash_kernel hash;
+    rasta_hash_batch_kernel hash_batch;
 } rasta_hashing_context_t;
 
 /**
@@ -28,6 +58,29 @@ typedef struct rasta_hashing_ctx {
  */
 void rasta_calculate_hash(struct RastaByteArray data, rasta_hashing_context_t *context, unsigned char *hash);
 
+/**
+ * The number of messages that rasta_calculate_hash_batch hashes in parallel at most
+ */
+#define RASTA_HASH_BATCH_SIZE 8
+
+/**
+ * Calculates the checksums of several independent messages using the same hashing context. MD4 checksums are
+ * calculated for up to RASTA_HASH_BATCH_SIZE messages in parallel, the other algorithms hash one message after the other.
+ * @param data the messages to hash
+ * @param count the number of messages
+ * @param context the hashing context that contains the neccessary parameters for hashing the data
+ * @param hashes the resulting hashes, one array per message
+ */
+void rasta_calculate_hash_batch(const struct RastaByteArray *data, unsigned int count, rasta_hashing_context_t *context, unsigned char *const *hashes);
+
+/**
+ * Prepares the keyed state of the hashing context and binds the kernels of the algorithm, needs to be called if the
+ * bytes of the key are changed directly.
+ * Changes of the algorithm or the hash length are picked up by rasta_calculate_hash.
+ * @param context the hashing context
+ */
+void rasta_hashing_context_prepare(rasta_hashing_context_t *context);
+
 /**
  * Sets the key of the hashing context based the the MD4 initial value
  * @param context the context where the key is set
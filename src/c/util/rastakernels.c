@@ -0,0 +1,56 @@
+#include "rastakernels.h"
+
+#include <pthread.h>
+
+#include "rastacrc.h"
+#include "rastamd4.h"
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+static unsigned int cpu_features = 0;
+static pthread_once_t cpu_features_once = PTHREAD_ONCE_INIT;
+
+static void probe_cpu_features(void) {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        cpu_features |= RASTA_CPU_CRC32C;
+    }
+    if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3")) {
+        cpu_features |= RASTA_CPU_CLMUL;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        cpu_features |= RASTA_CPU_AVX2;
+    }
+#elif defined(__aarch64__) && defined(__linux__)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+        cpu_features |= RASTA_CPU_CRC32C;
+    }
+#endif
+}
+
+unsigned int rasta_cpu_features() {
+    pthread_once(&cpu_features_once, probe_cpu_features);
+    return cpu_features;
+}
+
+int rasta_cpu_supports(unsigned int features) {
+    return (rasta_cpu_features() & features) == features;
+}
+
+void rasta_kernels_init(struct logger_t *logger) {
+    unsigned int features = rasta_cpu_features();
+    logger_log(logger, LOG_LEVEL_DEBUG, "RaSTA kernels", "CPU features: crc32c=%d clmul=%d avx2=%d",
+               (features & RASTA_CPU_CRC32C) != 0, (features & RASTA_CPU_CLMUL) != 0, (features & RASTA_CPU_AVX2) != 0);
+
+    struct crc_options options_b = crc_init_opt_b();
+    struct crc_options options_c = crc_init_opt_c();
+    struct crc_options options_d = crc_init_opt_d();
+    struct crc_options options_e = crc_init_opt_e();
+    logger_log(logger, LOG_LEVEL_INFO, "RaSTA kernels", "MD4 batch: %s, CRC b: %s, CRC c: %s, CRC d: %s, CRC e: %s",
+               md4_batch_kernel_name(), crc_kernel_name(&options_b), crc_kernel_name(&options_c),
+               crc_kernel_name(&options_d), crc_kernel_name(&options_e));
+}
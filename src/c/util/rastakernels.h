@@ -0,0 +1,47 @@
+/**
+ * This module probes the CPU features that the safety code and CRC kernels can make use of.
+ * Every algorithm registers its kernels from the fastest to the slowest together with the features they need, the
+ * first kernel whose features are available is bound when the algorithm is used for the first time.
+ * rasta_kernels_init binds all of them up front and logs the selection.
+ */
+
+#pragma once
+
+#include "../logging.h"
+
+/**
+ * CPU features that are used by the kernels
+ */
+typedef enum {
+    /**
+     * CRC32C instruction (SSE4.2 or the ARMv8 CRC extension)
+     */
+    RASTA_CPU_CRC32C = 1 << 0,
+    /**
+     * carry-less multiplication (PCLMULQDQ, together with SSSE3)
+     */
+    RASTA_CPU_CLMUL = 1 << 1,
+    /**
+     * 256 bit integer vectors (AVX2)
+     */
+    RASTA_CPU_AVX2 = 1 << 2
+} rasta_cpu_feature;
+
+/**
+ * Gets the features of the CPU, they are probed on the first call.
+ * @return the available rasta_cpu_feature flags
+ */
+unsigned int rasta_cpu_features();
+
+/**
+ * Checks if the CPU provides all of the given features.
+ * @param features rasta_cpu_feature flags
+ * @return 1 if all features are available, 0 otherwise
+ */
+int rasta_cpu_supports(unsigned int features);
+
+/**
+ * Probes the CPU features, binds the kernels of all algorithms and logs which kernels are used.
+ * @param logger the logger to use
+ */
+void rasta_kernels_init(struct logger_t *logger);
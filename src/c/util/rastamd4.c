@@ -1,9 +1,13 @@
 #include "rastamd4.h"
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "rastakernels.h"
+
 /*
  * The basic MD4 functions.
  */
@@ -238,16 +242,10 @@ void generateMD4(unsigned char *data, int length, int type, unsigned char *resul
     generateMD4WithVector(data, length, type, &context, result);
 }
 
-void generateMD4WithVector(unsigned char *data, int length, int type, MD4_CONTEXT *context, unsigned char *result) {
-    unsigned char MD4code[type == 2 ? 16 : 8];
-#ifdef USE_OPENSSL
-    MD4_Update(context, data, length);
-    MD4_Final(MD4code, context);
-#else
-    MD4_Update_Rasta(context, data, length);
-    MD4_Final_Rasta(MD4code, context);
-#endif
-
+/**
+ * writes the security code of the given @p type from the full MD4 hash to @p result
+ */
+static void md4_security_code(const unsigned char *MD4code, int type, unsigned char *result) {
     switch (type) {
     // 5.3.11 Sicherheitscode
     // kein Sicherheitscode
@@ -272,3 +270,233 @@ void generateMD4WithVector(unsigned char *data, int length, int type, MD4_CONTEX
         return;
     }
 }
+
+void generateMD4WithVector(unsigned char *data, int length, int type, MD4_CONTEXT *context, unsigned char *result) {
+    unsigned char MD4code[16];
+#ifdef USE_OPENSSL
+    MD4_Update(context, data, length);
+    MD4_Final(MD4code, context);
+#else
+    MD4_Update_Rasta(context, data, length);
+    MD4_Final_Rasta(MD4code, context);
+#endif
+
+    md4_security_code(MD4code, type, result);
+}
+
+#if !defined(USE_OPENSSL) && (defined(__GNUC__) || defined(__clang__))
+/*
+ * Multi-buffer MD4: every lane of a vector register holds the state of an independent message, so the rounds above
+ * hash 4 (SSE2 / NEON) or 8 (AVX2) messages at once. Lanes whose message has already ended keep their state.
+ */
+#define MD4_MULTI_BUFFER
+
+typedef MD4_u32plus md4_vec4 __attribute__((vector_size(16)));
+typedef MD4_u32plus md4_vec8 __attribute__((vector_size(32)));
+
+static const unsigned char md4_zero_block[64];
+
+static inline MD4_u32plus md4_load_word(const unsigned char *ptr) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    MD4_u32plus word;
+    memcpy(&word, ptr, sizeof(word));
+    return word;
+#else
+    return (MD4_u32plus)ptr[0] | ((MD4_u32plus)ptr[1] << 8) | ((MD4_u32plus)ptr[2] << 16) | ((MD4_u32plus)ptr[3] << 24);
+#endif
+}
+
+/**
+ * the message block of a lane, the last blocks with the padding and the length are taken from the tail buffer of the lane
+ */
+static const unsigned char *md4_lane_block(const unsigned char *data, unsigned long length, const unsigned char *tail, unsigned long block) {
+    unsigned long full_blocks = length / 64;
+    if (block < full_blocks) {
+        return &data[block * 64];
+    }
+    return &tail[(block - full_blocks) * 64];
+}
+
+#define MD4_LANES_KERNEL(name, vec, lanes, attributes)                                                                                \
+    attributes static void name(const MD4_CTX_RASTA *iv, unsigned char *const *data, const unsigned long *length, unsigned int count, \
+                                unsigned char (*digest)[16]) {                                                                        \
+        unsigned char tail[lanes][128];                                                                                               \
+        unsigned long blocks[lanes];                                                                                                  \
+        unsigned long max_blocks = 0;                                                                                                 \
+        const MD4_u32plus ac1 = 0x5a827999, ac2 = 0x6ed9eba1;                                                                         \
+                                                                                                                                      \
+        for (unsigned int l = 0; l < lanes; l++) {                                                                                    \
+            blocks[l] = 0;                                                                                                            \
+            if (l >= count) {                                                                                                         \
+                continue;                                                                                                             \
+            }                                                                                                                         \
+            /* the last partial block with the padding and the length in bits */                                                      \
+            unsigned long used = length[l] % 64;                                                                                      \
+            unsigned long tail_length = used < 56 ? 64 : 128;                                                                         \
+            memset(tail[l], 0, sizeof(tail[l]));                                                                                      \
+            memcpy(tail[l], &data[l][length[l] - used], used);                                                                        \
+            tail[l][used] = 0x80;                                                                                                     \
+            uint64_t bits = (uint64_t)length[l] << 3;                                                                                 \
+            for (int i = 0; i < 8; i++) {                                                                                             \
+                tail[l][tail_length - 8 + i] = (unsigned char)(bits >> (8 * i));                                                      \
+            }                                                                                                                         \
+            blocks[l] = length[l] / 64 + tail_length / 64;                                                                            \
+            if (blocks[l] > max_blocks) {                                                                                             \
+                max_blocks = blocks[l];                                                                                               \
+            }                                                                                                                         \
+        }                                                                                                                             \
+                                                                                                                                      \
+        vec a = (vec){0} + iv->a, b = (vec){0} + iv->b, c = (vec){0} + iv->c, d = (vec){0} + iv->d;                                   \
+        for (unsigned long block = 0; block < max_blocks; block++) {                                                                  \
+            vec m[16], active;                                                                                                        \
+            for (unsigned int l = 0; l < lanes; l++) {                                                                                \
+                const unsigned char *ptr = block < blocks[l] ? md4_lane_block(data[l], length[l], tail[l], block) : md4_zero_block;   \
+                for (int n = 0; n < 16; n++) {                                                                                        \
+                    m[n][l] = md4_load_word(&ptr[n * 4]);                                                                             \
+                }                                                                                                                     \
+                active[l] = block < blocks[l] ? 0xffffffff : 0;                                                                       \
+            }                                                                                                                         \
+                                                                                                                                      \
+            vec saved_a = a, saved_b = b, saved_c = c, saved_d = d;                                                                   \
+                                                                                                                                      \
+            /* Round 1 */                                                                                                             \
+            STEP(F, a, b, c, d, m[0], 3)                                                                                              \
+            STEP(F, d, a, b, c, m[1], 7)                                                                                              \
+            STEP(F, c, d, a, b, m[2], 11)                                                                                             \
+            STEP(F, b, c, d, a, m[3], 19)                                                                                             \
+            STEP(F, a, b, c, d, m[4], 3)                                                                                              \
+            STEP(F, d, a, b, c, m[5], 7)                                                                                              \
+            STEP(F, c, d, a, b, m[6], 11)                                                                                             \
+            STEP(F, b, c, d, a, m[7], 19)                                                                                             \
+            STEP(F, a, b, c, d, m[8], 3)                                                                                              \
+            STEP(F, d, a, b, c, m[9], 7)                                                                                              \
+            STEP(F, c, d, a, b, m[10], 11)                                                                                            \
+            STEP(F, b, c, d, a, m[11], 19)                                                                                            \
+            STEP(F, a, b, c, d, m[12], 3)                                                                                             \
+            STEP(F, d, a, b, c, m[13], 7)                                                                                             \
+            STEP(F, c, d, a, b, m[14], 11)                                                                                            \
+            STEP(F, b, c, d, a, m[15], 19)                                                                                            \
+                                                                                                                                      \
+            /* Round 2 */                                                                                                             \
+            STEP(G, a, b, c, d, m[0] + ac1, 3)                                                                                        \
+            STEP(G, d, a, b, c, m[4] + ac1, 5)                                                                                        \
+            STEP(G, c, d, a, b, m[8] + ac1, 9)                                                                                        \
+            STEP(G, b, c, d, a, m[12] + ac1, 13)                                                                                      \
+            STEP(G, a, b, c, d, m[1] + ac1, 3)                                                                                        \
+            STEP(G, d, a, b, c, m[5] + ac1, 5)                                                                                        \
+            STEP(G, c, d, a, b, m[9] + ac1, 9)                                                                                        \
+            STEP(G, b, c, d, a, m[13] + ac1, 13)                                                                                      \
+            STEP(G, a, b, c, d, m[2] + ac1, 3)                                                                                        \
+            STEP(G, d, a, b, c, m[6] + ac1, 5)                                                                                        \
+            STEP(G, c, d, a, b, m[10] + ac1, 9)                                                                                       \
+            STEP(G, b, c, d, a, m[14] + ac1, 13)                                                                                      \
+            STEP(G, a, b, c, d, m[3] + ac1, 3)                                                                                        \
+            STEP(G, d, a, b, c, m[7] + ac1, 5)                                                                                        \
+            STEP(G, c, d, a, b, m[11] + ac1, 9)                                                                                       \
+            STEP(G, b, c, d, a, m[15] + ac1, 13)                                                                                      \
+                                                                                                                                      \
+            /* Round 3 */                                                                                                             \
+            STEP(H, a, b, c, d, m[0] + ac2, 3)                                                                                        \
+            STEP(H, d, a, b, c, m[8] + ac2, 9)                                                                                        \
+            STEP(H, c, d, a, b, m[4] + ac2, 11)                                                                                       \
+            STEP(H, b, c, d, a, m[12] + ac2, 15)                                                                                      \
+            STEP(H, a, b, c, d, m[2] + ac2, 3)                                                                                        \
+            STEP(H, d, a, b, c, m[10] + ac2, 9)                                                                                       \
+            STEP(H, c, d, a, b, m[6] + ac2, 11)                                                                                       \
+            STEP(H, b, c, d, a, m[14] + ac2, 15)                                                                                      \
+            STEP(H, a, b, c, d, m[1] + ac2, 3)                                                                                        \
+            STEP(H, d, a, b, c, m[9] + ac2, 9)                                                                                        \
+            STEP(H, c, d, a, b, m[5] + ac2, 11)                                                                                       \
+            STEP(H, b, c, d, a, m[13] + ac2, 15)                                                                                      \
+            STEP(H, a, b, c, d, m[3] + ac2, 3)                                                                                        \
+            STEP(H, d, a, b, c, m[11] + ac2, 9)                                                                                       \
+            STEP(H, c, d, a, b, m[7] + ac2, 11)                                                                                       \
+            STEP(H, b, c, d, a, m[15] + ac2, 15)                                                                                      \
+                                                                                                                                      \
+            /* lanes whose message has ended keep their state */                                                                      \
+            a = saved_a + (a & active);                                                                                               \
+            b = saved_b + (b & active);                                                                                               \
+            c = saved_c + (c & active);                                                                                               \
+            d = saved_d + (d & active);                                                                                               \
+        }                                                                                                                             \
+                                                                                                                                      \
+        for (unsigned int l = 0; l < count; l++) {                                                                                    \
+            OUT(&digest[l][0], a[l])                                                                                                  \
+            OUT(&digest[l][4], b[l])                                                                                                  \
+            OUT(&digest[l][8], c[l])                                                                                                  \
+            OUT(&digest[l][12], d[l])                                                                                                 \
+        }                                                                                                                             \
+    }
+
+MD4_LANES_KERNEL(md4_lanes4, md4_vec4, 4, )
+
+#if defined(__x86_64__)
+MD4_LANES_KERNEL(md4_lanes8, md4_vec8, 8, __attribute__((target("avx2"))))
+#endif
+#endif
+
+#ifdef MD4_MULTI_BUFFER
+/**
+ * the multi-buffer kernels, from the fastest to the slowest
+ */
+static const struct {
+    const char *name;
+    unsigned int required_features;
+    unsigned int lanes;
+    void (*kernel)(const MD4_CTX_RASTA *iv, unsigned char *const *data, const unsigned long *length, unsigned int count, unsigned char (*digest)[16]);
+} md4_batch_kernels[] = {
+#if defined(__x86_64__)
+    {"avx2, 8 lanes", RASTA_CPU_AVX2, 8, md4_lanes8},
+#endif
+    {"vector, 4 lanes", 0, 4, md4_lanes4},
+};
+
+static unsigned int md4_batch_kernel = 0;
+static pthread_once_t md4_batch_kernel_once = PTHREAD_ONCE_INIT;
+
+static void md4_select_batch_kernel(void) {
+    for (unsigned int i = 0; i < sizeof(md4_batch_kernels) / sizeof(md4_batch_kernels[0]); i++) {
+        if (rasta_cpu_supports(md4_batch_kernels[i].required_features)) {
+            md4_batch_kernel = i;
+            return;
+        }
+    }
+}
+#endif
+
+const char *md4_batch_kernel_name() {
+#ifdef MD4_MULTI_BUFFER
+    pthread_once(&md4_batch_kernel_once, md4_select_batch_kernel);
+    return md4_batch_kernels[md4_batch_kernel].name;
+#elif defined(USE_OPENSSL)
+    return "openssl, 1 lane";
+#else
+    return "scalar, 1 lane";
+#endif
+}
+
+void generateMD4Batch(unsigned char *const *data, const unsigned long *length, unsigned int count, int type, const MD4_CONTEXT *context, unsigned char *const *result) {
+#ifdef MD4_MULTI_BUFFER
+    pthread_once(&md4_batch_kernel_once, md4_select_batch_kernel);
+    unsigned int lanes = md4_batch_kernels[md4_batch_kernel].lanes;
+
+    unsigned char digest[8][16];
+    while (count > 1) {
+        unsigned int n = count < lanes ? count : lanes;
+        md4_batch_kernels[md4_batch_kernel].kernel(context, data, length, n, digest);
+
+        for (unsigned int i = 0; i < n; i++) {
+            md4_security_code(digest[i], type, result[i]);
+        }
+        data += n;
+        length += n;
+        result += n;
+        count -= n;
+    }
+#endif
+
+    for (unsigned int i = 0; i < count; i++) {
+        MD4_CONTEXT md4_ctx = *context;
+        generateMD4WithVector(data[i], (int)length[i], type, &md4_ctx, result[i]);
+    }
+}
@@ -48,3 +48,21 @@ void generateMD4(unsigned char *data, int length, int type, unsigned char *resul
  * @param result array for the result
  */
 void generateMD4WithVector(unsigned char *data, int length, int type, MD4_CONTEXT *context, unsigned char *result);
+
+/**
+ * generates the MD4 security codes of several independent messages, using the same initial value for all of them.
+ * Up to 8 messages are hashed in parallel with SIMD instructions.
+ * @param data the messages
+ * @param length the lengths of the messages
+ * @param count the number of messages
+ * @param type of security code (0 means no code, 1 means half the code, 2 all of the code)
+ * @param context the initial context for all messages, see md4InitContext. It is not changed.
+ * @param result arrays for the results
+ */
+void generateMD4Batch(unsigned char *const *data, const unsigned long *length, unsigned int count, int type, const MD4_CONTEXT *context, unsigned char *const *result);
+
+/**
+ * gets the name of the kernel that is used by generateMD4Batch
+ * @return the name of the kernel
+ */
+const char *md4_batch_kernel_name();
@@ -90,31 +90,58 @@ void packFields(struct RastaByteArray result, struct RastaPacket *packet) {
     hostLongToLe(packet->confirmed_timestamp, &result.bytes[24]);
 }
 
+void rastaModuleSealBytes(struct RastaPacket *packet, unsigned char *bytes, rasta_hashing_context_t *hashing_context) {
+    struct RastaByteArray view;
+    view.bytes = bytes;
+    view.length = packet->length;
+    packFields(view, packet);
+
+    // calculate the safety code over everything in front of it, directly in the buffer
+    unsigned int checksum_len = hashing_context->hash_length * 8;
+    if (checksum_len > 0) {
+        unsigned char checksum[16];
+        view.length = (unsigned int)(packet->length - checksum_len);
+        rasta_calculate_hash(view, hashing_context, checksum);
+        rmemcpy(&bytes[packet->length - checksum_len], checksum, checksum_len);
+    }
+}
+
+void rastaModuleSealBytesBatch(struct RastaPacket *packets, unsigned char *const *bytes, unsigned int count, rasta_hashing_context_t *hashing_context) {
+    unsigned int checksum_len = hashing_context->hash_length * 8;
+    for (unsigned int i = 0; i < count; i += RASTA_HASH_BATCH_SIZE) {
+        unsigned int n = count - i < RASTA_HASH_BATCH_SIZE ? count - i : RASTA_HASH_BATCH_SIZE;
+        struct RastaByteArray views[RASTA_HASH_BATCH_SIZE];
+        unsigned char *checksums[RASTA_HASH_BATCH_SIZE];
+        unsigned char checksum_buffers[RASTA_HASH_BATCH_SIZE][16];
+
+        for (unsigned int j = 0; j < n; j++) {
+            views[j].bytes = bytes[i + j];
+            views[j].length = packets[i + j].length;
+            packFields(views[j], &packets[i + j]);
+            views[j].length = (unsigned int)(packets[i + j].length - checksum_len);
+            checksums[j] = checksum_buffers[j];
+        }
+
+        if (checksum_len > 0) {
+            rasta_calculate_hash_batch(views, n, hashing_context, checksums);
+            for (unsigned int j = 0; j < n; j++) {
+                rmemcpy(&bytes[i + j][packets[i + j].length - checksum_len], checksums[j], checksum_len);
+            }
+        }
+    }
+}
+
 struct RastaByteArray rastaModuleToBytes(struct RastaPacket *packet, rasta_hashing_context_t *hashing_context) {
     struct RastaByteArray result;
     result = allocateBytes(packet, hashing_context);
 
     if (rastamodule_lasterror != RASTA_ERRORS_NONE) return result;
 
-    packFields(result, packet);
-
     // pack data
     unsigned int len = getDataLength(packet, hashing_context);
     rmemcpy(&result.bytes[28], packet->data.bytes, len);
 
-    // calculate md4 checksum
-    unsigned char checksum[16];
-    unsigned int checksum_len = hashing_context->hash_length * 8;
-
-    struct RastaByteArray data_to_hash;
-    allocateRastaByteArray(&data_to_hash, (unsigned int)(packet->length - checksum_len));
-    rmemcpy(data_to_hash.bytes, result.bytes, (unsigned int)(packet->length - checksum_len));
-
-    rasta_calculate_hash(data_to_hash, hashing_context, checksum);
-
-    freeRastaByteArray(&data_to_hash);
-
-    rmemcpy(&result.bytes[28 + len], checksum, checksum_len);
+    rastaModuleSealBytes(packet, result.bytes, hashing_context);
 
     return result;
 }
@@ -187,64 +214,65 @@ void bytesToRastaPacket(struct RastaByteArray data, rasta_hashing_context_t *has
     unsigned int checksum_len = hashing_context->hash_length * 8;
 
     struct RastaByteArray data_to_hash;
-    allocateRastaByteArray(&data_to_hash, (unsigned int)(result->length - checksum_len));
-
-    rmemcpy(data_to_hash.bytes, data.bytes, data_to_hash.length);
+    data_to_hash.bytes = data.bytes;
+    data_to_hash.length = (unsigned int)(result->length - checksum_len);
 
     rasta_calculate_hash(data_to_hash, hashing_context, checksum);
 
-    freeRastaByteArray(&data_to_hash);
-
     allocateRastaByteArray(&result->checksum, checksum_len);
     rmemcpy(result->checksum.bytes, &data.bytes[28 + len], checksum_len);
     result->checksum_correct = (rmemcmp(&checksum, &data.bytes[28 + len], checksum_len) == 0);
 }
 
-struct RastaByteArray rastaRedundancyPacketToBytes(struct RastaRedundancyPacket *packet, rasta_hashing_context_t *hashing_context) {
-    uint8_t checksum_storage[sizeof(uint32_t)];
-    struct RastaByteArray result;
-    allocateRastaByteArray(&result, packet->length);
-
+void rastaRedundancySealBytes(struct RastaRedundancyPacket *packet, unsigned char *bytes) {
     // pack packet length
-    hostShortTole(packet->length, &result.bytes[0]);
+    hostShortTole(packet->length, &bytes[0]);
 
     // pack reserve bytes
-    hostShortTole(packet->reserve, &result.bytes[2]);
+    hostShortTole(packet->reserve, &bytes[2]);
 
     // pack sequence number
-    hostLongToLe(packet->sequence_number, &result.bytes[4]);
-
-    // convert internal RaSTA packet to bytes
-    unsigned int internal_packet_len = packet->data.length;
-    struct RastaByteArray internal_packet_bytes = rastaModuleToBytes(&packet->data, hashing_context);
-
-    // pack data into result
-    rmemcpy(&result.bytes[8], internal_packet_bytes.bytes, internal_packet_len);
-
-    // initialize a byte array containing all data except checksum
-    // this is needed, as otherwise the 0s/unset bytes in the result byte array will be used in calculating the checksum
-    struct RastaByteArray temp_wo_checksum;
-    unsigned int len_wo_checksum = (unsigned int)packet->length - (packet->checksum_type.width / 8);
-    allocateRastaByteArray(&temp_wo_checksum, len_wo_checksum);
-
-    // copy data
-    rmemcpy(temp_wo_checksum.bytes, result.bytes, len_wo_checksum);
+    hostLongToLe(packet->sequence_number, &bytes[4]);
+
+    // generate the checksum over everything in front of it, directly in the buffer
+    unsigned int checksum_len = packet->checksum_type->width / 8;
+    if (checksum_len > 0) {
+        uint8_t checksum_storage[sizeof(uint32_t)];
+        struct RastaByteArray view;
+        view.bytes = bytes;
+        view.length = (unsigned int)packet->length - checksum_len;
+        unsigned long checksum = crc_calculate(packet->checksum_type, view);
+
+        // pack checksum
+        hostLongToLe(checksum, checksum_storage);
+        rmemcpy(&bytes[packet->length - checksum_len], checksum_storage, checksum_len);
+    }
+}
 
-    // generate checksum
-    unsigned long checksum = crc_calculate(&packet->checksum_type, temp_wo_checksum);
+struct RastaByteArray rastaRedundancyPacketToBytes(struct RastaRedundancyPacket *packet, rasta_hashing_context_t *hashing_context) {
+    struct RastaByteArray result;
+    allocateRastaByteArray(&result, packet->length);
 
-    // pack checksum
-    hostLongToLe(checksum, checksum_storage);
-    rmemcpy(&result.bytes[8 + internal_packet_len], checksum_storage, (packet->checksum_type.width / 8));
+    // serialize the internal RaSTA packet directly behind the redundancy header
+    unsigned int data_len = getDataLength(&packet->data, hashing_context);
+    rmemcpy(&result.bytes[8 + 28], packet->data.data.bytes, data_len);
+    rastaModuleSealBytes(&packet->data, &result.bytes[8], hashing_context);
 
-    // free the temporary checksum data
-    freeRastaByteArray(&internal_packet_bytes);
-    freeRastaByteArray(&temp_wo_checksum);
+    rastaRedundancySealBytes(packet, result.bytes);
 
     return result;
 }
 
-void bytesToRastaRedundancyPacket(struct RastaByteArray data, struct crc_options checksum_type, rasta_hashing_context_t *hashing_context, struct RastaRedundancyPacket *packet) {
+void rasta_decode_context_init(rasta_decode_context_t *context, struct crc_options *checksum_type, rasta_hashing_context_t *hashing_context) {
+    if (checksum_type->width > 0) {
+        crc_generate_table(checksum_type);
+    }
+    context->checksum_type = checksum_type;
+    context->hashing_context = hashing_context;
+}
+
+void bytesToRastaRedundancyPacket(struct RastaByteArray data, const rasta_decode_context_t *context, struct RastaRedundancyPacket *packet) {
+    struct crc_options *checksum_type = context->checksum_type;
     packet->checksum_type = checksum_type;
 
     // length
@@ -259,49 +287,33 @@ void bytesToRastaRedundancyPacket(struct RastaByteArray data, struct crc_options
     // length of the carried data (the rasta packet) is total length - 8 bytes of length, reserve and seq nr before
     // and the in the checksum_type specified amount of bytes for the checksum after the data (divided by 8 because
     // the crc length is specified in bits)
-    unsigned int data_len = data.length - 8 - (checksum_type.width / 8);
+    unsigned int data_len = data.length - 8 - (checksum_type->width / 8);
 
+    // convert the internal data bytes to a rasta packet
     struct RastaByteArray internal_packet_bytes;
-    allocateRastaByteArray(&internal_packet_bytes, data_len);
-
-    // copy internal data bytes
-    for (unsigned int i = 0; i < data_len; ++i) {
-        internal_packet_bytes.bytes[i] = data.bytes[8 + i];
-    }
-
-    // convert to rasta packet
-    bytesToRastaPacket(internal_packet_bytes, hashing_context, &packet->data);
-
-    // free the packet bytes
-    freeRastaByteArray(&internal_packet_bytes);
+    internal_packet_bytes.bytes = &data.bytes[8];
+    internal_packet_bytes.length = data_len;
+    bytesToRastaPacket(internal_packet_bytes, context->hashing_context, &packet->data);
 
     // calculate the checksum of the received data
     struct RastaByteArray data_wo_checksum;
-    unsigned int data_wo_checksum_len = data.length - (checksum_type.width / 8);
-    allocateRastaByteArray(&data_wo_checksum, data_wo_checksum_len);
-
-    // copy data
-    for (unsigned int j = 0; j < data_wo_checksum_len; ++j) {
-        data_wo_checksum.bytes[j] = data.bytes[j];
-    }
-
-    // calculate the actual checksum
-    unsigned long calculated_checksum = crc_calculate(&checksum_type, data_wo_checksum);
-
-    // free data
-    freeRastaByteArray(&data_wo_checksum);
+    data_wo_checksum.bytes = data.bytes;
+    data_wo_checksum.length = data.length - (checksum_type->width / 8);
 
     // checksum check
     packet->checksum_correct = 1;
 
-    if (data.length == data_wo_checksum_len) {
+    if (data.length == data_wo_checksum.length) {
         // no checksum was used, nothing to check
         return;
     }
 
+    // calculate the actual checksum
+    unsigned long calculated_checksum = crc_calculate(checksum_type, data_wo_checksum);
+
     // convert the previously calculated checksum into byte array for comparison with data checksum
     unsigned char data_checksum[4];
     hostLongToLe(calculated_checksum, data_checksum);
 
-    packet->checksum_correct = (rmemcmp(data_checksum, &data.bytes[8 + data_len], (checksum_type.width / 8)) == 0);
+    packet->checksum_correct = (rmemcmp(data_checksum, &data.bytes[8 + data_len], (checksum_type->width / 8)) == 0);
 }
@@ -184,11 +184,34 @@ struct RastaRedundancyPacket {
     int checksum_correct;
 
     /**
-     * the parameters of the checksum that is used
+     * the parameters of the checksum that is used, not owned by the packet
      */
-    struct crc_options checksum_type;
+    struct crc_options *checksum_type;
 };
 
+/**
+ * the parameters for decoding received RaSTA redundancy layer PDUs, built once per redundancy channel
+ * so that nothing has to be prepared or copied for each received PDU
+ */
+typedef struct rasta_decode_ctx {
+    /**
+     * the options of the redundancy layer checksum, the CRC lookup table is already generated
+     */
+    struct crc_options *checksum_type;
+    /**
+     * the hashing parameters that are used for the SR layer hash
+     */
+    rasta_hashing_context_t *hashing_context;
+} rasta_decode_context_t;
+
+/**
+ * initializes a decode context and generates the CRC lookup table of the @p checksum_type
+ * @param context the context to initialize
+ * @param checksum_type the options of the redundancy layer checksum, has to outlive the context
+ * @param hashing_context the hashing parameters that are used for the SR layer hash, has to outlive the context
+ */
+void rasta_decode_context_init(rasta_decode_context_t *context, struct crc_options *checksum_type, rasta_hashing_context_t *hashing_context);
+
 /**
  * Accepts a rasta packet and converts it into an allocated bytearray
  * @param packet the packet
@@ -197,6 +220,24 @@ struct RastaRedundancyPacket {
  */
 struct RastaByteArray rastaModuleToBytes(struct RastaPacket *packet, rasta_hashing_context_t *hashing_context);
 
+/**
+ * Packs the fields of a rasta packet into a buffer that already contains the data of the packet at offset 28
+ * and appends the safety code, without copying the data.
+ * @param packet the packet, its length determines the layout of the buffer
+ * @param bytes the buffer, at least packet->length bytes
+ * @param hashing_context configuration of the hashing algorithm used by RaSTA
+ */
+void rastaModuleSealBytes(struct RastaPacket *packet, unsigned char *bytes, rasta_hashing_context_t *hashing_context);
+
+/**
+ * Seals several packets like rastaModuleSealBytes, the safety codes are calculated with rasta_calculate_hash_batch.
+ * @param packets the packets
+ * @param bytes the buffers of the packets
+ * @param count the number of packets
+ * @param hashing_context configuration of the hashing algorithm used by RaSTA
+ */
+void rastaModuleSealBytesBatch(struct RastaPacket *packets, unsigned char *const *bytes, unsigned int count, rasta_hashing_context_t *hashing_context);
+
 /**
  * Accepts a rasta packet and converts it into an allocated bytearray without calculating the safety code
  * @param packet the packet
@@ -221,12 +262,20 @@ void bytesToRastaPacket(struct RastaByteArray data, rasta_hashing_context_t *has
  */
 struct RastaByteArray rastaRedundancyPacketToBytes(struct RastaRedundancyPacket *packet, rasta_hashing_context_t *hashing_context);
 
+/**
+ * Packs the header of a RaSTA redundancy layer packet into a buffer that already contains the serialized
+ * internal packet at offset 8 and appends the CRC checksum, without copying the internal packet.
+ * @param packet the redundancy layer packet, its length determines the layout of the buffer
+ * @param bytes the buffer, at least packet->length bytes
+ */
+void rastaRedundancySealBytes(struct RastaRedundancyPacket *packet, unsigned char *bytes);
+
 /**
  * Accepts a byte array and converts it into a RaSTA redundancy layer packet
  * This function will check whether the CRC checksum is correct and set the flag RastaRedundancyPacket#checksum_correct
  * @param data the byte array which contains the packet
- * @param checksum_type the options that were used to generate the checksum in the @p data byte array
- * @param hashing_context the hashing parameters that are used for the SR layer hash
+ * @param context the checksum options that were used to generate the checksum in the @p data byte array and the
+ * hashing parameters that are used for the SR layer hash
  * @param packet a RaSTA Redundancy layer packet that will contain all data that was in the @p data byte array
  */
-void bytesToRastaRedundancyPacket(struct RastaByteArray data, struct crc_options checksum_type, rasta_hashing_context_t *hashing_context, struct RastaRedundancyPacket *packet);
+void bytesToRastaRedundancyPacket(struct RastaByteArray data, const rasta_decode_context_t *context, struct RastaRedundancyPacket *packet);
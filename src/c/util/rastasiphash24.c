@@ -2,6 +2,11 @@
 
 #include "rmemory.h"
 
+static int siphash_keyed(const uint8_t *in, const size_t inlen, const uint64_t *v,
+                         uint8_t *out, const size_t outlen);
+static int halfsiphash_keyed(const uint8_t *in, const size_t inlen, const uint32_t *v,
+                             uint8_t *out, const size_t outlen);
+
 void generateSiphash24(const unsigned char *data, int data_length, const unsigned char *key, int hash_type, unsigned char *result) {
     switch (hash_type) {
     case 1:
@@ -20,6 +25,22 @@ void generateSiphash24(const unsigned char *data, int data_length, const unsigne
     }
 }
 
+void generateSiphash24WithState(const unsigned char *data, int data_length, const rasta_siphash_state *state, int hash_type, unsigned char *result) {
+    switch (hash_type) {
+    case 1:
+        halfsiphash_keyed(data, (const size_t)data_length, state->half_v, result, 8);
+        break;
+    case 2:
+        siphash_keyed(data, (const size_t)data_length, state->v, result, 16);
+        break;
+    default:
+        // default no checksum
+        // if no hash is wanted, return 8 zero bytes
+        memset(result, 0, 8);
+        break;
+    }
+}
+
 /*
    SipHash reference C implementation
    Copyright (c) 2012-2016 Jean-Philippe Aumasson
@@ -138,25 +159,35 @@ void generateSiphash24(const unsigned char *data, int data_length, const unsigne
 #define TRACE_H
 #endif
 
-int siphash(const uint8_t *in, const size_t inlen, const uint8_t *k,
-            uint8_t *out, const size_t outlen) {
-
-    assert((outlen == 8) || (outlen == 16));
-    uint64_t v0 = 0x736f6d6570736575ULL;
-    uint64_t v1 = 0x646f72616e646f6dULL;
-    uint64_t v2 = 0x6c7967656e657261ULL;
-    uint64_t v3 = 0x7465646279746573ULL;
+void rasta_siphash_init_state(rasta_siphash_state *state, const uint8_t *k) {
     uint64_t k0 = U8TO64_LE(k);
     uint64_t k1 = U8TO64_LE(k + 8);
+    state->v[0] = 0x736f6d6570736575ULL ^ k0;
+    state->v[1] = 0x646f72616e646f6dULL ^ k1;
+    state->v[2] = 0x6c7967656e657261ULL ^ k0;
+    state->v[3] = 0x7465646279746573ULL ^ k1;
+
+    uint32_t hk0 = U8TO32_LE(k);
+    uint32_t hk1 = U8TO32_LE(k + 4);
+    state->half_v[0] = hk0;
+    state->half_v[1] = hk1;
+    state->half_v[2] = 0x6c796765 ^ hk0;
+    state->half_v[3] = 0x74656462 ^ hk1;
+}
+
+static int siphash_keyed(const uint8_t *in, const size_t inlen, const uint64_t *v,
+                         uint8_t *out, const size_t outlen) {
+
+    assert((outlen == 8) || (outlen == 16));
+    uint64_t v0 = v[0];
+    uint64_t v1 = v[1];
+    uint64_t v2 = v[2];
+    uint64_t v3 = v[3];
     uint64_t m;
     int i;
     const uint8_t *end = in + inlen - (inlen % sizeof(uint64_t));
     const int left = inlen & 7;
     uint64_t b = ((uint64_t)inlen) << 56;
-    v3 ^= k1;
-    v2 ^= k0;
-    v1 ^= k1;
-    v0 ^= k0;
 
     if (outlen == 16)
         v1 ^= 0xee;
@@ -233,25 +264,26 @@ int siphash(const uint8_t *in, const size_t inlen, const uint8_t *k,
     return 0;
 }
 
-int halfsiphash(const uint8_t *in, const size_t inlen, const uint8_t *k,
-                uint8_t *out, const size_t outlen) {
+int siphash(const uint8_t *in, const size_t inlen, const uint8_t *k,
+            uint8_t *out, const size_t outlen) {
+    rasta_siphash_state state;
+    rasta_siphash_init_state(&state, k);
+    return siphash_keyed(in, inlen, state.v, out, outlen);
+}
+
+static int halfsiphash_keyed(const uint8_t *in, const size_t inlen, const uint32_t *v,
+                             uint8_t *out, const size_t outlen) {
 
     assert((outlen == 4) || (outlen == 8));
-    uint32_t v0 = 0;
-    uint32_t v1 = 0;
-    uint32_t v2 = 0x6c796765;
-    uint32_t v3 = 0x74656462;
-    uint32_t k0 = U8TO32_LE(k);
-    uint32_t k1 = U8TO32_LE(k + 4);
+    uint32_t v0 = v[0];
+    uint32_t v1 = v[1];
+    uint32_t v2 = v[2];
+    uint32_t v3 = v[3];
     uint32_t m;
     int i;
     const uint8_t *end = in + inlen - (inlen % sizeof(uint32_t));
     const int left = inlen & 3;
     uint32_t b = ((uint32_t)inlen) << 24;
-    v3 ^= k1;
-    v2 ^= k0;
-    v1 ^= k1;
-    v0 ^= k0;
 
     if (outlen == 8)
         v1 ^= 0xee;
@@ -315,3 +347,10 @@ int halfsiphash(const uint8_t *in, const size_t inlen, const uint8_t *k,
 
     return 0;
 }
+
+int halfsiphash(const uint8_t *in, const size_t inlen, const uint8_t *k,
+                uint8_t *out, const size_t outlen) {
+    rasta_siphash_state state;
+    rasta_siphash_init_state(&state, k);
+    return halfsiphash_keyed(in, inlen, state.half_v, out, outlen);
+}
@@ -5,6 +5,20 @@
 #include <stdio.h>
 #include <string.h>
 
+/**
+ * The SipHash and HalfSipHash states after the key has been applied, can be reused for all messages with the same key
+ */
+typedef struct {
+    /**
+     * initial v0 - v3 of SipHash
+     */
+    uint64_t v[4];
+    /**
+     * initial v0 - v3 of HalfSipHash
+     */
+    uint32_t half_v[4];
+} rasta_siphash_state;
+
 /**
  * generates a SipHash 2-4 hash for the given data data and saves it in result
  * @param data array of the data
@@ -15,6 +29,23 @@
  */
 void generateSiphash24(const unsigned char *data, int data_length, const unsigned char *key, int hash_type, unsigned char *result);
 
+/**
+ * applies a key to the initial SipHash and HalfSipHash states
+ * @param state the state to initialize
+ * @param k the key, 16 bytes (the first 8 bytes are used for HalfSipHash)
+ */
+void rasta_siphash_init_state(rasta_siphash_state *state, const uint8_t *k);
+
+/**
+ * generates a SipHash 2-4 hash like generateSiphash24, starting from a state that has been initialized with the key
+ * @param data array of the data
+ * @param data_length length of data
+ * @param state the keyed state, see rasta_siphash_init_state
+ * @param hash_type type of security code (0 means no code, 1 means first 8 bytes, 2 means first 16 bytes)
+ * @param result array for the result
+ */
+void generateSiphash24WithState(const unsigned char *data, int data_length, const rasta_siphash_state *state, int hash_type, unsigned char *result);
+
 int siphash(const uint8_t *in, size_t inlen, const uint8_t *k,
             uint8_t *out, size_t outlen);
 
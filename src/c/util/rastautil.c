@@ -1,5 +1,6 @@
 #include "rastautil.h"
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -33,11 +34,15 @@ uint32_t cur_timestamp() {
 
 void freeRastaByteArray(struct RastaByteArray *data) {
     data->length = 0;
-    rfree(data->bytes);
+    rmem_pool_free(data->bytes);
 }
 
 void allocateRastaByteArray(struct RastaByteArray *data, unsigned int length) {
-    data->bytes = rmalloc(length);
+    allocateRastaByteArrayFromPool(data, length, rmem_pool_active());
+}
+
+void allocateRastaByteArrayFromPool(struct RastaByteArray *data, unsigned int length, rmem_pool_t *pool) {
+    data->bytes = rmem_pool_alloc(pool, length);
     memset(data->bytes, 0, length);
     data->length = length;
 }
@@ -58,3 +63,17 @@ uint32_t leLongToHost(const unsigned char v[4]) {
     uint32_t *result = (uint32_t *)v;
     return rasta_le32toh(*result);
 }
+
+unsigned int round_up_to_power_of_two(unsigned int value) {
+    // the highest power of two, doubling it would wrap around to 0
+    const unsigned int highest = UINT_MAX / 2 + 1;
+    if (value > highest) {
+        return 0;
+    }
+
+    unsigned int result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
@@ -2,6 +2,8 @@
 
 #include <stdint.h>
 
+#include "rmemory.h"
+
 #define NS_PER_S 1000000000ULL
 #define MS_PER_S 1000ULL
 #define NS_PER_MS 1000000ULL
@@ -18,12 +20,20 @@ struct RastaByteArray {
 void freeRastaByteArray(struct RastaByteArray *data);
 
 /**
- * Allocates space for the bytearray
+ * Allocates space for the bytearray from the buffer pool that is active on the calling thread (see rmem_pool_activate)
  * @param data the data
  * @param length the length
  */
 void allocateRastaByteArray(struct RastaByteArray *data, unsigned int length);
 
+/**
+ * Allocates space for the bytearray from the given buffer pool
+ * @param data the data
+ * @param length the length
+ * @param pool the pool to allocate from, NULL to allocate from the heap
+ */
+void allocateRastaByteArrayFromPool(struct RastaByteArray *data, unsigned int length, rmem_pool_t *pool);
+
 /**
  * this will generate a 4 byte timestamp of the current system time
  * @return current system time in s since 1970
@@ -45,3 +55,10 @@ void hostLongToLe(uint32_t v, unsigned char *result);
  * @return the ulong
  */
 uint32_t leLongToHost(const unsigned char v[4]);
+
+/**
+ * Rounds up to the next power of two, e.g. for the capacity of a ring buffer whose positions wrap around with a mask
+ * @param value the minimum result
+ * @return the smallest power of two >= value (1 for 0), or 0 if it does not fit into an unsigned int
+ */
+unsigned int round_up_to_power_of_two(unsigned int value);
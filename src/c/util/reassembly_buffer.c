@@ -0,0 +1,121 @@
+#include "reassembly_buffer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rmemory.h"
+
+static unsigned int reassembly_buffer_byte(reassembly_buffer_t *buffer, unsigned int index) {
+    return buffer->data[(buffer->head + index) & (buffer->capacity - 1)];
+}
+
+static unsigned int reassembly_buffer_pdu_length(reassembly_buffer_t *buffer, unsigned int offset) {
+    return reassembly_buffer_byte(buffer, offset) | reassembly_buffer_byte(buffer, offset + 1) << 8;
+}
+
+/**
+ * Copies @p length buffered bytes starting at @p offset to @p dest, the bytes may wrap around the end of the ring
+ */
+static void reassembly_buffer_copy(reassembly_buffer_t *buffer, unsigned int offset, unsigned int length, unsigned char *dest) {
+    unsigned int start = (buffer->head + offset) & (buffer->capacity - 1);
+    unsigned int first = buffer->capacity - start < length ? buffer->capacity - start : length;
+    rmemcpy(dest, &buffer->data[start], first);
+    rmemcpy(&dest[first], buffer->data, length - first);
+}
+
+void reassembly_buffer_init(reassembly_buffer_t *buffer) {
+    buffer->data = NULL;
+    buffer->capacity = 0;
+    buffer->head = 0;
+    buffer->size = 0;
+    buffer->linear = NULL;
+}
+
+void reassembly_buffer_destroy(reassembly_buffer_t *buffer) {
+    rfree(buffer->data);
+    rfree(buffer->linear);
+    reassembly_buffer_init(buffer);
+}
+
+void reassembly_buffer_clear(reassembly_buffer_t *buffer) {
+    buffer->head = 0;
+    buffer->size = 0;
+}
+
+unsigned char *reassembly_buffer_write_area(reassembly_buffer_t *buffer, unsigned int min_free, unsigned int *length) {
+    if (buffer->size == 0) {
+        // the whole buffer is contiguous again
+        buffer->head = 0;
+    }
+
+    if (buffer->capacity - buffer->size < min_free) {
+        unsigned int capacity = buffer->capacity > 0 ? buffer->capacity : 1;
+        while (capacity - buffer->size < min_free) {
+            capacity <<= 1;
+        }
+
+        // the buffered bytes are moved to the start of the new ring
+        unsigned char *data = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, capacity);
+        if (buffer->size > 0) {
+            reassembly_buffer_copy(buffer, 0, buffer->size, data);
+        }
+        rfree(buffer->data);
+        buffer->data = data;
+        buffer->capacity = capacity;
+        buffer->head = 0;
+    }
+
+    unsigned int tail = (buffer->head + buffer->size) & (buffer->capacity - 1);
+    if (tail < (buffer->head & (buffer->capacity - 1)) || buffer->size == buffer->capacity) {
+        // the free space lies between tail and head
+        *length = buffer->capacity - buffer->size;
+    } else {
+        // the free space lies behind tail, up to the end of the ring
+        *length = buffer->capacity - tail;
+    }
+    return &buffer->data[tail];
+}
+
+void reassembly_buffer_commit(reassembly_buffer_t *buffer, unsigned int length) {
+    buffer->size += length;
+}
+
+unsigned int reassembly_buffer_missing(reassembly_buffer_t *buffer) {
+    if (buffer->size < 2) {
+        return 2 - buffer->size;
+    }
+
+    unsigned int length = reassembly_buffer_pdu_length(buffer, 0);
+    return length > buffer->size ? length - buffer->size : 0;
+}
+
+int reassembly_buffer_next(reassembly_buffer_t *buffer, unsigned int min_length, unsigned char **pdu) {
+    if (buffer->size < 2) {
+        return 0;
+    }
+
+    unsigned int length = reassembly_buffer_pdu_length(buffer, 0);
+    if (length < min_length) {
+        return -1;
+    }
+    if (length > buffer->size) {
+        // incomplete, the rest has not been received yet
+        return 0;
+    }
+
+    unsigned int start = buffer->head & (buffer->capacity - 1);
+    if (length > buffer->capacity - start) {
+        // the PDU wraps around the end of the ring, hand out a linear copy
+        if (buffer->linear == NULL) {
+            buffer->linear = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, UINT16_MAX);
+        }
+        reassembly_buffer_copy(buffer, 0, length, buffer->linear);
+        *pdu = buffer->linear;
+    } else {
+        *pdu = &buffer->data[start];
+    }
+
+    buffer->head += length;
+    buffer->size -= length;
+    return (int)length;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+/**
+ * Reassembles length-prefixed PDUs from a byte stream, implemented as a growable ring buffer.
+ * Every PDU starts with its total length (including the prefix) as 2-byte little-endian value.
+ */
+typedef struct {
+    /**
+     * The slots of the ring buffer, NULL until data is written for the first time
+     */
+    unsigned char *data;
+    /**
+     * The amount of slots in the ring buffer, always a power of two
+     */
+    unsigned int capacity;
+    /**
+     * The position of the first buffered byte, the slot is head & (capacity - 1)
+     */
+    unsigned int head;
+    /**
+     * The amount of buffered bytes
+     */
+    unsigned int size;
+    /**
+     * Holds a PDU that wraps around the end of the ring while it is handed out
+     */
+    unsigned char *linear;
+} reassembly_buffer_t;
+
+/**
+ * Initializes an empty reassembly buffer, memory is allocated when data is written for the first time.
+ * @param buffer the buffer to initialize
+ */
+void reassembly_buffer_init(reassembly_buffer_t *buffer);
+
+/**
+ * Frees the memory of the buffer, the buffered bytes are discarded.
+ * @param buffer the buffer to use
+ */
+void reassembly_buffer_destroy(reassembly_buffer_t *buffer);
+
+/**
+ * Discards the buffered bytes, e.g. when the stream has been closed. The memory is kept.
+ * @param buffer the buffer to use
+ */
+void reassembly_buffer_clear(reassembly_buffer_t *buffer);
+
+/**
+ * Gets the contiguous free space behind the buffered bytes, the buffer grows if less than @p min_free bytes are free.
+ * Data written to the area has to be added with reassembly_buffer_commit.
+ * @param buffer the buffer to use
+ * @param min_free the amount of free bytes the buffer needs to have
+ * @param length the size of the returned area, may be smaller than min_free if the free space wraps around
+ * @return the start of the area
+ */
+unsigned char *reassembly_buffer_write_area(reassembly_buffer_t *buffer, unsigned int min_free, unsigned int *length);
+
+/**
+ * Adds bytes that have been written to the area returned by reassembly_buffer_write_area.
+ * @param buffer the buffer to use
+ * @param length the amount of bytes that have been written
+ */
+void reassembly_buffer_commit(reassembly_buffer_t *buffer, unsigned int length);
+
+/**
+ * Gets the amount of bytes that are missing to complete the first buffered PDU.
+ * @param buffer the buffer to use
+ * @return the amount of missing bytes, 0 if the first PDU is complete
+ */
+unsigned int reassembly_buffer_missing(reassembly_buffer_t *buffer);
+
+/**
+ * Removes the first PDU from the buffer if it is complete. The PDU is handed out in place, only a PDU that
+ * wraps around the end of the ring is copied. The returned bytes stay valid until the buffer is used again.
+ * @param buffer the buffer to use
+ * @param min_length the smallest valid PDU length
+ * @param pdu set to the start of the PDU
+ * @return the length of the PDU, 0 if it is not complete yet, or -1 if the length prefix is smaller than min_length
+ */
+int reassembly_buffer_next(reassembly_buffer_t *buffer, unsigned int min_length, unsigned char **pdu);
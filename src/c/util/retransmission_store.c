@@ -0,0 +1,91 @@
+#include "retransmission_store.h"
+
+#include "rastautil.h"
+#include "rmemory.h"
+
+retransmission_store_t *retransmission_store_init(unsigned int max_size) {
+    unsigned int capacity = round_up_to_power_of_two(max_size);
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    retransmission_store_t *store = rmalloc_tagged(RASTA_MEMORY_TAG_FIFO, sizeof(retransmission_store_t));
+
+    store->size = 0;
+    store->max_size = max_size;
+    store->capacity = capacity;
+    store->head = 0;
+    store->entries = rmalloc_tagged(RASTA_MEMORY_TAG_FIFO, capacity * sizeof(struct retransmission_entry));
+
+    return store;
+}
+
+void retransmission_store_destroy(retransmission_store_t **store) {
+    if (*store != NULL) {
+        struct retransmission_entry entry;
+        while (retransmission_store_pop(*store, &entry)) {
+            freeRastaByteArray(&entry.buffer);
+        }
+        rfree((*store)->entries);
+        rfree(*store);
+    }
+    *store = NULL;
+}
+
+int retransmission_store_push(retransmission_store_t *store, uint32_t sequence_number, uint32_t timestamp,
+                              struct RastaByteArray buffer, unsigned int offset, unsigned int length) {
+    if (store->size == store->max_size) {
+        return 0;
+    }
+
+    struct retransmission_entry *entry = &store->entries[(store->head + store->size) & (store->capacity - 1)];
+    entry->sequence_number = sequence_number;
+    entry->timestamp = timestamp;
+    entry->buffer = buffer;
+    entry->offset = offset;
+    entry->length = length;
+    store->size++;
+    return 1;
+}
+
+int retransmission_store_pop(retransmission_store_t *store, struct retransmission_entry *entry) {
+    if (store->size == 0) {
+        return 0;
+    }
+
+    *entry = store->entries[store->head & (store->capacity - 1)];
+    store->head++;
+    store->size--;
+    return 1;
+}
+
+unsigned int retransmission_store_confirm(retransmission_store_t *store, uint32_t confirmed_sequence_number) {
+    unsigned int removed = 0;
+    struct retransmission_entry entry;
+    while (retransmission_store_pop(store, &entry)) {
+        freeRastaByteArray(&entry.buffer);
+        removed++;
+
+        // entries are in the order they were sent, everything after this one is not confirmed yet
+        if (entry.sequence_number == confirmed_sequence_number) {
+            break;
+        }
+    }
+    return removed;
+}
+
+struct retransmission_entry *retransmission_store_get(retransmission_store_t *store, unsigned int index) {
+    if (index >= store->size) {
+        return NULL;
+    }
+
+    return &store->entries[(store->head + index) & (store->capacity - 1)];
+}
+
+unsigned int retransmission_store_size(retransmission_store_t *store) {
+    return store->size;
+}
+
+int retransmission_store_full(retransmission_store_t *store) {
+    return store->size == store->max_size;
+}
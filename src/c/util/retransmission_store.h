@@ -0,0 +1,123 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "rastautil.h"
+
+/**
+ * A sent PDU that has not been confirmed yet
+ */
+struct retransmission_entry {
+    /**
+     * The sequence number of the PDU
+     */
+    uint32_t sequence_number;
+    /**
+     * The timestamp of the PDU
+     */
+    uint32_t timestamp;
+    /**
+     * The buffer containing the serialized PDU, owned by the store
+     */
+    struct RastaByteArray buffer;
+    /**
+     * The position of the PDU in the buffer, leaves room for the headers of lower layers
+     */
+    unsigned int offset;
+    /**
+     * The length of the PDU
+     */
+    unsigned int length;
+};
+
+/**
+ * Ring of sent PDUs in the order they were sent, so entries can be confirmed by sequence number
+ * without parsing the stored bytes.
+ */
+typedef struct {
+    /**
+     * The amount of entries in the store
+     */
+    unsigned int size;
+    /**
+     * The maximum amount of entries in the store
+     */
+    unsigned int max_size;
+    /**
+     * The amount of slots in the ring, the smallest power of two >= max_size
+     */
+    unsigned int capacity;
+    /**
+     * The position of the oldest entry, the slot is head & (capacity - 1)
+     */
+    unsigned int head;
+    /**
+     * The slots of the ring
+     */
+    struct retransmission_entry *entries;
+} retransmission_store_t;
+
+/**
+ * Initializes an empty store.
+ * @param max_size maximum amount of entries in the store
+ * @return an initialized store, NULL if max_size is larger than the largest power of two of an unsigned int
+ */
+retransmission_store_t *retransmission_store_init(unsigned int max_size);
+
+/**
+ * Destroys the given store and frees the buffers of all entries that are still inside.
+ * @param store the store to free, set to NULL
+ */
+void retransmission_store_destroy(retransmission_store_t **store);
+
+/**
+ * Adds a sent PDU to the store.
+ * @param store the store to use
+ * @param sequence_number the sequence number of the PDU
+ * @param timestamp the timestamp of the PDU
+ * @param buffer the buffer containing the PDU, ownership is only taken on success
+ * @param offset the position of the PDU in the buffer
+ * @param length the length of the PDU
+ * @return 1 on success, 0 if the store is full
+ */
+int retransmission_store_push(retransmission_store_t *store, uint32_t sequence_number, uint32_t timestamp,
+                              struct RastaByteArray buffer, unsigned int offset, unsigned int length);
+
+/**
+ * Removes the oldest entry from the store.
+ * @param store the store to use
+ * @param entry the removed entry is written to, the caller takes ownership of its buffer
+ * @return 1 if an entry was removed, 0 if the store is empty
+ */
+int retransmission_store_pop(retransmission_store_t *store, struct retransmission_entry *entry);
+
+/**
+ * Removes and frees all entries up to and including the one with the given sequence number,
+ * or all entries if none has the sequence number.
+ * @param store the store to use
+ * @param confirmed_sequence_number the last confirmed sequence number
+ * @return the amount of removed entries
+ */
+unsigned int retransmission_store_confirm(retransmission_store_t *store, uint32_t confirmed_sequence_number);
+
+/**
+ * Retrieves an entry without removing it, can be used to iterate over the store.
+ * @param store the store to use
+ * @param index the position of the entry, 0 is the oldest entry
+ * @return the entry or NULL if index is not smaller than the amount of entries
+ */
+struct retransmission_entry *retransmission_store_get(retransmission_store_t *store, unsigned int index);
+
+/**
+ * Gets the amount of entries in the store.
+ * @param store the store to use
+ * @return the amount of entries
+ */
+unsigned int retransmission_store_size(retransmission_store_t *store);
+
+/**
+ * Checks if the store has reached its maximum capacity.
+ * @param store the store to use
+ * @return 1 if the capacity has been reached, 0 otherwise
+ */
+int retransmission_store_full(retransmission_store_t *store);
@@ -1,18 +1,117 @@
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "rmemory.h"
 
+struct rmem_context {
+    rasta_allocator allocator;
+    /**
+     * Counters per tag, updated atomically since rasta_submit allocates on foreign threads
+     */
+    atomic_uint_fast64_t calls[RASTA_MEMORY_TAG_COUNT];
+    atomic_uint_fast64_t bytes[RASTA_MEMORY_TAG_COUNT];
+};
+
+#define RMEM_POOL_MAX_CLASSES 4
+
+// blocks added to a size class at once when its free list is empty
+#define RMEM_POOL_CHUNK_BLOCKS 16
+
+/**
+ * Header in front of every block returned by rmem_pool_alloc
+ */
+struct rmem_pool_block {
+    /**
+     * The pool the block belongs to, NULL for blocks from the heap
+     */
+    struct rmem_pool *pool;
+    union {
+        /**
+         * The next free block of the size class while the block is in the free list
+         */
+        struct rmem_pool_block *next;
+        /**
+         * The size class the block is returned to while it is in use
+         */
+        struct rmem_pool_class *size_class;
+        /**
+         * Keeps the memory behind the header aligned for any type
+         */
+        max_align_t align;
+    };
+};
+
+struct rmem_pool_class {
+    /**
+     * The usable size of the blocks in this class
+     */
+    unsigned int block_size;
+    struct rmem_pool_block *free_list;
+};
+
+struct rmem_pool_chunk {
+    struct rmem_pool_chunk *next;
+};
+
+struct rmem_pool {
+    /**
+     * The size classes in ascending order
+     */
+    struct rmem_pool_class classes[RMEM_POOL_MAX_CLASSES];
+    unsigned int class_count;
+    /**
+     * All memory allocated by the pool, released when the pool is destroyed
+     */
+    struct rmem_pool_chunk *chunks;
+    unsigned int blocks_in_use;
+    bool destroyed;
+};
+
+static _Thread_local rmem_context_t *active_context = NULL;
+
+static _Thread_local rmem_pool_t *active_pool = NULL;
+
+static void rmem_context_count(rmem_context_t *context, rasta_memory_tag tag, unsigned int size) {
+    atomic_fetch_add_explicit(&context->calls[tag], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&context->bytes[tag], size, memory_order_relaxed);
+}
+
 void *rmalloc(unsigned int size) {
-    return malloc(size);
+    return rmalloc_tagged(RASTA_MEMORY_TAG_OTHER, size);
+}
+
+void *rmalloc_tagged(rasta_memory_tag tag, unsigned int size) {
+    rmem_context_t *context = active_context;
+    if (context == NULL) {
+        return malloc(size);
+    }
+    rmem_context_count(context, tag, size);
+    return context->allocator.alloc(context->allocator.user_data, size, tag);
 }
 
 void *rrealloc(void *element, unsigned int size) {
-    return realloc(element, size);
+    return rrealloc_tagged(RASTA_MEMORY_TAG_OTHER, element, size);
+}
+
+void *rrealloc_tagged(rasta_memory_tag tag, void *element, unsigned int size) {
+    rmem_context_t *context = active_context;
+    if (context == NULL) {
+        return realloc(element, size);
+    }
+    rmem_context_count(context, tag, size);
+    return context->allocator.realloc(context->allocator.user_data, element, size, tag);
 }
 
 void rfree(void *element) {
-    free(element);
+    rmem_context_t *context = active_context;
+    if (context == NULL) {
+        free(element);
+        return;
+    }
+    context->allocator.free(context->allocator.user_data, element);
 }
 
 void *rmemcpy(void *dest, const void *src, unsigned int n) {
@@ -34,3 +133,199 @@ void rstrcat(char *dest, const char *src) {
 int rmemcmp(const void *a, const void *b, unsigned int len) {
     return memcmp(a, b, len);
 }
+
+static void *rmem_libc_alloc(void *user_data, size_t size, rasta_memory_tag tag) {
+    (void)user_data;
+    (void)tag;
+    return malloc(size);
+}
+
+static void *rmem_libc_realloc(void *user_data, void *ptr, size_t size, rasta_memory_tag tag) {
+    (void)user_data;
+    (void)tag;
+    return realloc(ptr, size);
+}
+
+static void rmem_libc_free(void *user_data, void *ptr) {
+    (void)user_data;
+    free(ptr);
+}
+
+rmem_context_t *rmem_context_init(const rasta_allocator *allocator) {
+    rasta_allocator libc_allocator = {rmem_libc_alloc, rmem_libc_realloc, rmem_libc_free, NULL};
+    if (allocator == NULL) {
+        allocator = &libc_allocator;
+    }
+
+    rmem_context_t *context = allocator->alloc(allocator->user_data, sizeof(rmem_context_t), RASTA_MEMORY_TAG_OTHER);
+    context->allocator = *allocator;
+    for (unsigned int i = 0; i < RASTA_MEMORY_TAG_COUNT; i++) {
+        atomic_init(&context->calls[i], 0);
+        atomic_init(&context->bytes[i], 0);
+    }
+    rmem_context_count(context, RASTA_MEMORY_TAG_OTHER, sizeof(rmem_context_t));
+
+    return context;
+}
+
+void rmem_context_destroy(rmem_context_t **context) {
+    if (*context != NULL) {
+        if (active_context == *context) {
+            active_context = NULL;
+        }
+        rasta_allocator allocator = (*context)->allocator;
+        allocator.free(allocator.user_data, *context);
+    }
+    *context = NULL;
+}
+
+rmem_context_t *rmem_context_activate(rmem_context_t *context) {
+    rmem_context_t *previous = active_context;
+    active_context = context;
+    return previous;
+}
+
+void rmem_context_stats(rmem_context_t *context, rasta_memory_stats *stats) {
+    for (unsigned int i = 0; i < RASTA_MEMORY_TAG_COUNT; i++) {
+        stats->calls[i] = atomic_load_explicit(&context->calls[i], memory_order_relaxed);
+        stats->bytes[i] = atomic_load_explicit(&context->bytes[i], memory_order_relaxed);
+    }
+}
+
+rmem_pool_t *rmem_pool_init(const unsigned int *block_sizes, unsigned int count) {
+    rmem_pool_t *pool = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, sizeof(rmem_pool_t));
+    memset(pool, 0, sizeof(rmem_pool_t));
+
+    for (unsigned int i = 0; i < count; i++) {
+        // round up to keep the following headers aligned
+        unsigned int size = (block_sizes[i] + sizeof(max_align_t) - 1) / sizeof(max_align_t) * sizeof(max_align_t);
+
+        // insertion sort, ignoring duplicates
+        unsigned int pos = 0;
+        while (pos < pool->class_count && pool->classes[pos].block_size < size) {
+            pos++;
+        }
+        if ((pos < pool->class_count && pool->classes[pos].block_size == size) || pool->class_count == RMEM_POOL_MAX_CLASSES) {
+            continue;
+        }
+        memmove(&pool->classes[pos + 1], &pool->classes[pos], (pool->class_count - pos) * sizeof(struct rmem_pool_class));
+        pool->classes[pos].block_size = size;
+        pool->classes[pos].free_list = NULL;
+        pool->class_count++;
+    }
+
+    return pool;
+}
+
+static void rmem_pool_release(rmem_pool_t *pool) {
+    struct rmem_pool_chunk *chunk = pool->chunks;
+    while (chunk != NULL) {
+        struct rmem_pool_chunk *next = chunk->next;
+        rfree(chunk);
+        chunk = next;
+    }
+    rfree(pool);
+}
+
+void rmem_pool_destroy(rmem_pool_t **pool) {
+    if (*pool != NULL) {
+        if (active_pool == *pool) {
+            active_pool = NULL;
+        }
+        if ((*pool)->blocks_in_use == 0) {
+            rmem_pool_release(*pool);
+        } else {
+            (*pool)->destroyed = true;
+        }
+    }
+    *pool = NULL;
+}
+
+/**
+ * adds a chunk of free blocks to a size class
+ */
+static void rmem_pool_grow(rmem_pool_t *pool, struct rmem_pool_class *size_class) {
+    size_t stride = sizeof(struct rmem_pool_block) + size_class->block_size;
+    size_t offset = (sizeof(struct rmem_pool_chunk) + sizeof(max_align_t) - 1) / sizeof(max_align_t) * sizeof(max_align_t);
+    struct rmem_pool_chunk *chunk = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, offset + RMEM_POOL_CHUNK_BLOCKS * stride);
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+
+    unsigned char *blocks = (unsigned char *)chunk + offset;
+    for (unsigned int i = 0; i < RMEM_POOL_CHUNK_BLOCKS; i++) {
+        struct rmem_pool_block *block = (struct rmem_pool_block *)(blocks + i * stride);
+        block->pool = pool;
+        block->next = size_class->free_list;
+        size_class->free_list = block;
+    }
+}
+
+void *rmem_pool_alloc(rmem_pool_t *pool, unsigned int size) {
+    struct rmem_pool_class *size_class = NULL;
+    if (pool != NULL) {
+        for (unsigned int i = 0; i < pool->class_count && size_class == NULL; i++) {
+            if (size <= pool->classes[i].block_size) {
+                size_class = &pool->classes[i];
+            }
+        }
+    }
+
+    struct rmem_pool_block *block;
+    if (size_class == NULL) {
+        block = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, sizeof(struct rmem_pool_block) + size);
+        block->pool = NULL;
+    } else {
+        if (size_class->free_list == NULL) {
+            rmem_pool_grow(pool, size_class);
+        }
+        block = size_class->free_list;
+        size_class->free_list = block->next;
+        pool->blocks_in_use++;
+    }
+    block->size_class = size_class;
+    return block + 1;
+}
+
+void rmem_pool_free(void *element) {
+    if (element == NULL) {
+        return;
+    }
+
+    struct rmem_pool_block *block = (struct rmem_pool_block *)element - 1;
+    rmem_pool_t *pool = block->pool;
+    if (pool == NULL) {
+        rfree(block);
+        return;
+    }
+
+    struct rmem_pool_class *size_class = block->size_class;
+    block->next = size_class->free_list;
+    size_class->free_list = block;
+    pool->blocks_in_use--;
+
+    if (pool->destroyed && pool->blocks_in_use == 0) {
+        rmem_pool_release(pool);
+    }
+}
+
+rmem_pool_t *rmem_pool_activate(rmem_pool_t *pool) {
+    rmem_pool_t *previous = active_pool;
+    active_pool = pool;
+    return previous;
+}
+
+rmem_pool_t *rmem_pool_active(void) {
+    return active_pool;
+}
+
+rmem_scope_t rmem_scope_enter(rmem_context_t *context, rmem_pool_t *pool) {
+    rmem_scope_t previous;
+    previous.context = rmem_context_activate(context);
+    previous.pool = rmem_pool_activate(pool);
+    return previous;
+}
+
+void rmem_scope_leave(rmem_scope_t scope) {
+    rmem_context_activate(scope.context);
+    rmem_pool_activate(scope.pool);
+}
@@ -1,5 +1,20 @@
 #pragma once
 
+#include <rasta/memory.h>
+
+/**
+ * Allocator and allocation counters of a RaSTA instance. The context that is active on the calling thread
+ * is used by rmalloc, rrealloc and rfree, without an active context memory comes from the C library.
+ */
+typedef struct rmem_context rmem_context_t;
+
+/**
+ * Pool of fixed-size blocks in a few size classes. Freed blocks are kept in per-class free lists,
+ * so a pool that has grown to its working set serves allocations without touching the heap.
+ * A pool must only be used from one thread at a time. Its memory is accounted as RASTA_MEMORY_TAG_PACKET.
+ */
+typedef struct rmem_pool rmem_pool_t;
+
 /**
  * Allocates memory of size
  * @param size the size of the memory
@@ -7,6 +22,14 @@
  */
 void *rmalloc(unsigned int size);
 
+/**
+ * Allocates memory of size, accounted to the given subsystem
+ * @param tag the subsystem the memory is used by
+ * @param size the size of the memory
+ * @return pointer to memory
+ */
+void *rmalloc_tagged(rasta_memory_tag tag, unsigned int size);
+
 /**
  * reallocates memory for element with size
  * @param element
@@ -14,6 +37,15 @@ void *rmalloc(unsigned int size);
  * @return
  */
 void *rrealloc(void *element, unsigned int size);
+
+/**
+ * reallocates memory for element with size, accounted to the given subsystem
+ * @param tag the subsystem the memory is used by
+ * @param element
+ * @param size
+ * @return
+ */
+void *rrealloc_tagged(rasta_memory_tag tag, void *element, unsigned int size);
 /**
  * frees an allocated memory
  * @param element pointer to the memory
@@ -61,3 +93,94 @@ void rstrcat(char *dest, const char *src);
  * @return < 0 if if a < b, > 0 if a > b or 0 if a == b
  */
 int rmemcmp(const void *a, const void *b, unsigned int len);
+
+/**
+ * Creates a memory context. The memory of the context itself is allocated with the given allocator.
+ * @param allocator the allocator to use, copied into the context, NULL to use the C library
+ * @return the context
+ */
+rmem_context_t *rmem_context_init(const rasta_allocator *allocator);
+
+/**
+ * Destroys a memory context and deactivates it if it is active on the calling thread.
+ * Memory that was allocated with the context must have been freed before.
+ * @param context the context to destroy, set to NULL
+ */
+void rmem_context_destroy(rmem_context_t **context);
+
+/**
+ * Sets the memory context used for allocations on the calling thread.
+ * @param context the context, NULL to use the C library
+ * @return the previously active context
+ */
+rmem_context_t *rmem_context_activate(rmem_context_t *context);
+
+/**
+ * Reads the allocation counters of a memory context. Can be called from any thread.
+ * @param context the context
+ * @param stats the counters are written to
+ */
+void rmem_context_stats(rmem_context_t *context, rasta_memory_stats *stats);
+
+/**
+ * Creates an empty pool, blocks are allocated in chunks on demand and reused after being freed.
+ * @param block_sizes the sizes of the size classes
+ * @param count the amount of size classes (at most 4), duplicates are ignored
+ * @return the pool
+ */
+rmem_pool_t *rmem_pool_init(const unsigned int *block_sizes, unsigned int count);
+
+/**
+ * Destroys a pool. If blocks of the pool are still in use, the memory is released when the last one is freed.
+ * @param pool the pool to destroy, set to NULL
+ */
+void rmem_pool_destroy(rmem_pool_t **pool);
+
+/**
+ * Allocates memory from the smallest size class that fits.
+ * @param pool the pool to allocate from, if NULL or if size exceeds the largest size class, the memory is allocated from the heap
+ * @param size the size of the memory
+ * @return pointer to memory, which has to be freed with rmem_pool_free
+ */
+void *rmem_pool_alloc(rmem_pool_t *pool, unsigned int size);
+
+/**
+ * Frees memory allocated with rmem_pool_alloc, returning it to the pool it came from.
+ * @param element pointer to the memory, can be NULL
+ */
+void rmem_pool_free(void *element);
+
+/**
+ * Sets the pool used for allocations on the calling thread that do not specify a pool (e.g. allocateRastaByteArray).
+ * @param pool the pool, NULL to allocate from the heap
+ * @return the previously active pool
+ */
+rmem_pool_t *rmem_pool_activate(rmem_pool_t *pool);
+
+/**
+ * Gets the pool that is active on the calling thread.
+ * @return the active pool or NULL
+ */
+rmem_pool_t *rmem_pool_active(void);
+
+/**
+ * The memory context and pool that were active on a thread before rmem_scope_enter
+ */
+typedef struct {
+    rmem_context_t *context;
+    rmem_pool_t *pool;
+} rmem_scope_t;
+
+/**
+ * Activates a memory context and pool on the calling thread, e.g. when entering a public function of an instance.
+ * @param context the context to activate
+ * @param pool the pool to activate
+ * @return the previously active context and pool, to be restored with rmem_scope_leave
+ */
+rmem_scope_t rmem_scope_enter(rmem_context_t *context, rmem_pool_t *pool);
+
+/**
+ * Restores the memory context and pool that were active before the matching rmem_scope_enter.
+ * @param scope the value returned by rmem_scope_enter
+ */
+void rmem_scope_leave(rmem_scope_t scope);
@@ -0,0 +1,67 @@
+#include "send_buffer.h"
+
+#include <stddef.h>
+
+#include "rmemory.h"
+
+void send_buffer_init(send_buffer_t *buffer, unsigned int capacity) {
+    buffer->data = NULL;
+    buffer->capacity = capacity;
+    buffer->head = 0;
+    buffer->size = 0;
+}
+
+void send_buffer_destroy(send_buffer_t *buffer) {
+    rfree(buffer->data);
+    send_buffer_init(buffer, buffer->capacity);
+}
+
+void send_buffer_clear(send_buffer_t *buffer) {
+    buffer->head = 0;
+    buffer->size = 0;
+}
+
+bool send_buffer_push(send_buffer_t *buffer, const unsigned char *bytes, unsigned int length) {
+    if (length > buffer->capacity - buffer->size) {
+        return false;
+    }
+
+    if (buffer->data == NULL) {
+        buffer->data = rmalloc_tagged(RASTA_MEMORY_TAG_PACKET, buffer->capacity);
+    }
+
+    // the bytes may wrap around the end of the ring
+    unsigned int tail = (buffer->head + buffer->size) & (buffer->capacity - 1);
+    unsigned int first = buffer->capacity - tail < length ? buffer->capacity - tail : length;
+    rmemcpy(&buffer->data[tail], bytes, first);
+    rmemcpy(buffer->data, &bytes[first], length - first);
+    buffer->size += length;
+    return true;
+}
+
+int send_buffer_iov(send_buffer_t *buffer, struct iovec iov[2]) {
+    if (buffer->size == 0) {
+        return 0;
+    }
+
+    unsigned int start = buffer->head & (buffer->capacity - 1);
+    unsigned int first = buffer->capacity - start < buffer->size ? buffer->capacity - start : buffer->size;
+    iov[0].iov_base = &buffer->data[start];
+    iov[0].iov_len = first;
+    if (first == buffer->size) {
+        return 1;
+    }
+
+    iov[1].iov_base = buffer->data;
+    iov[1].iov_len = buffer->size - first;
+    return 2;
+}
+
+void send_buffer_consume(send_buffer_t *buffer, unsigned int length) {
+    buffer->head += length;
+    buffer->size -= length;
+    if (buffer->size == 0) {
+        // the next bytes start at the beginning of the ring again, so they are written in one piece
+        buffer->head = 0;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdbool.h>
+#include <sys/uio.h>
+
+/**
+ * Holds the bytes of a stream that could not be written yet, implemented as a ring buffer of fixed size.
+ * Data is only added as a whole, so the buffer never ends in the middle of a PDU.
+ */
+typedef struct {
+    /**
+     * The slots of the ring buffer, NULL until data is added for the first time
+     */
+    unsigned char *data;
+    /**
+     * The amount of slots in the ring buffer, always a power of two
+     */
+    unsigned int capacity;
+    /**
+     * The position of the first queued byte, the slot is head & (capacity - 1)
+     */
+    unsigned int head;
+    /**
+     * The amount of queued bytes
+     */
+    unsigned int size;
+} send_buffer_t;
+
+/**
+ * Initializes an empty send buffer, memory is allocated when data is added for the first time.
+ * @param buffer the buffer to initialize
+ * @param capacity the maximum amount of queued bytes, has to be a power of two
+ */
+void send_buffer_init(send_buffer_t *buffer, unsigned int capacity);
+
+/**
+ * Frees the memory of the buffer, the queued bytes are discarded.
+ * @param buffer the buffer to use
+ */
+void send_buffer_destroy(send_buffer_t *buffer);
+
+/**
+ * Discards the queued bytes, e.g. when the stream has been closed. The memory is kept.
+ * @param buffer the buffer to use
+ */
+void send_buffer_clear(send_buffer_t *buffer);
+
+/**
+ * Adds bytes to the end of the buffer.
+ * @param buffer the buffer to use
+ * @param bytes the bytes to add
+ * @param length the amount of bytes
+ * @return true if the bytes have been added, false if they do not fit (nothing is added then)
+ */
+bool send_buffer_push(send_buffer_t *buffer, const unsigned char *bytes, unsigned int length);
+
+/**
+ * Describes the queued bytes for writev, the bytes may wrap around the end of the ring.
+ * @param buffer the buffer to use
+ * @param iov receives up to two areas, the first one starts with the oldest byte
+ * @return the amount of used entries in @p iov, 0 if the buffer is empty
+ */
+int send_buffer_iov(send_buffer_t *buffer, struct iovec iov[2]);
+
+/**
+ * Removes bytes that have been written from the start of the buffer.
+ * @param buffer the buffer to use
+ * @param length the amount of bytes that have been written
+ */
+void send_buffer_consume(send_buffer_t *buffer, unsigned int length);
@@ -196,6 +196,10 @@ typedef struct rasta_config_redundancy {
     unsigned int t_seq;
     int n_diagnose;
     unsigned int n_deferqueue_size;
+    /**
+     * Non-standard extension: let the kernel segment and coalesce UDP datagrams (UDP_SEGMENT / UDP_GRO) where supported
+     */
+    bool udp_offload;
 } rasta_config_redundancy;
 
 /**
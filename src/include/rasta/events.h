@@ -28,6 +28,14 @@ typedef struct timed_event {
     uint64_t interval;
     uint64_t last_call;
     char enabled;
+    /**
+     * the event system this event was added to, NULL if it is not part of any event system
+     */
+    event_system *ev_sys;
+    /**
+     * position in the timer queue of the event system plus one, 0 if the event is not scheduled (do not set)
+     */
+    unsigned int queue_index;
 } timed_event;
 
 /**
@@ -41,6 +49,15 @@ typedef struct fd_event {
     int fd;
     int options;
     char enabled;
+    /**
+     * the event system this event was added to, NULL if it is not part of any event system
+     */
+    event_system *ev_sys;
+    /**
+     * the fd and options this event is currently registered with in the event system backend (do not set)
+     */
+    int registered_fd;
+    int registered_options;
 } fd_event;
 
 /**
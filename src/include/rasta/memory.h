@@ -0,0 +1,82 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" { // only need to export C interface if
+             // used by C++ source code
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The subsystems the allocations of a RaSTA instance are accounted to
+ */
+typedef enum {
+    /**
+     * Everything without a more specific tag (handles, connections, event system, ...)
+     */
+    RASTA_MEMORY_TAG_OTHER,
+    /**
+     * Queues of the safety and retransmission layer
+     */
+    RASTA_MEMORY_TAG_FIFO,
+    /**
+     * Payloads and containers of messages and PDUs
+     */
+    RASTA_MEMORY_TAG_PACKET,
+    /**
+     * The defer queue of the redundancy layer
+     */
+    RASTA_MEMORY_TAG_DEFERQUEUE,
+    /**
+     * Formatted log messages
+     */
+    RASTA_MEMORY_TAG_LOGGING,
+    /**
+     * Secrets of the key exchange
+     */
+    RASTA_MEMORY_TAG_KEX,
+    RASTA_MEMORY_TAG_COUNT
+} rasta_memory_tag;
+
+/**
+ * Allocator used by a RaSTA instance for all of its memory.
+ * The functions are called from the thread running the event loop and from threads calling rasta_submit,
+ * so they have to be thread-safe if rasta_submit is used.
+ */
+typedef struct {
+    /**
+     * allocates size bytes, aligned for any type
+     */
+    void *(*alloc)(void *user_data, size_t size, rasta_memory_tag tag);
+    /**
+     * resizes memory returned by alloc or realloc, ptr may be NULL
+     */
+    void *(*realloc)(void *user_data, void *ptr, size_t size, rasta_memory_tag tag);
+    /**
+     * frees memory returned by alloc or realloc, ptr may be NULL
+     */
+    void (*free)(void *user_data, void *ptr);
+    /**
+     * passed to every call of the functions above
+     */
+    void *user_data;
+} rasta_allocator;
+
+/**
+ * Allocation counters of a RaSTA instance, indexed by rasta_memory_tag
+ */
+typedef struct {
+    /**
+     * The amount of calls to allocate or resize memory
+     */
+    uint64_t calls[RASTA_MEMORY_TAG_COUNT];
+    /**
+     * The sum of the requested sizes in bytes
+     */
+    uint64_t bytes[RASTA_MEMORY_TAG_COUNT];
+} rasta_memory_stats;
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,6 +10,7 @@ extern "C" { // only need to export C interface if
 
 #include "config.h"
 #include "events.h"
+#include "memory.h"
 #include "notification.h"
 #include "rastarole.h"
 
@@ -25,6 +26,21 @@ typedef struct rasta_cancellation rasta_cancellation;
  */
 rasta *rasta_lib_init_configuration(rasta_config_info *config, log_level log_level, logger_type logger_type);
 
+/**
+ * initializes the RaSTA handle like rasta_lib_init_configuration, but takes all memory of the instance from the given allocator
+ * @param config the configuration to initialize the handle with
+ * @param allocator the allocator to use (all functions must be set), copied into the instance, NULL to use the C library
+ */
+rasta *rasta_lib_init_configuration_with_allocator(rasta_config_info *config, log_level log_level, logger_type logger_type,
+                                                   const rasta_allocator *allocator);
+
+/**
+ * Get the allocation counters of a RaSTA instance per subsystem, can be called from any thread
+ * @param rasta the user configuration of the local RaSTA instance
+ * @param stats the counters are written to
+ */
+void rasta_get_memory_stats(rasta *r, rasta_memory_stats *stats);
+
 /**
  * binds a RaSTA instance to the configured IP addresses and ports for the transport channels
  * @param rasta the user configuration to be used
@@ -75,6 +91,87 @@ rasta_connection *rasta_connect(rasta *r);
  */
 int rasta_recv(rasta *r, rasta_connection *connection, void *buf, size_t len);
 
+/**
+ * A received message lent to the application by rasta_recv_borrow
+ */
+typedef struct {
+    /**
+     * the content of the message, read-only
+     */
+    const void *data;
+    /**
+     * the length of the message in bytes
+     */
+    size_t length;
+    /**
+     * used by rasta_recv_release, do not modify
+     */
+    void *handle;
+} rasta_message;
+
+/**
+ * Receive a message on a given RaSTA connection without copying it. The message points directly into the buffer
+ * of the received PDU and stays valid until it is given back with rasta_recv_release.
+ * @param rasta the user configuration of the local RaSTA instance
+ * @param connection the connection from which to receive the data
+ * @param message the received message is written to
+ * @return 0 on success, -1 if the connection is not up
+ */
+int rasta_recv_borrow(rasta *r, rasta_connection *connection, rasta_message *message);
+
+/**
+ * Give back a message from rasta_recv_borrow. Must be called on the thread running the event loop.
+ * @param rasta the user configuration of the local RaSTA instance
+ * @param message the message, cleared afterwards
+ */
+void rasta_recv_release(rasta *r, rasta_message *message);
+
+/**
+ * Get the amount of received messages that can be read with rasta_recv without waiting
+ * @param connection the connection to check
+ */
+unsigned int rasta_recv_queue_size(rasta_connection *connection);
+
+/**
+ * Run the event loop of a RaSTA instance until an event callback returns nonzero or the timeout expired.
+ * The callbacks of the stack do so when a message was received or the state of a connection changed, all other events
+ * (e.g. heartbeats or fd events added with rasta_add_fd_event that return 0) are processed until the timeout.
+ * Timers keep their schedule between calls, so this can be called repeatedly from an application loop.
+ * @param rasta the user configuration of the local RaSTA instance
+ * @param timeout_ms the maximum time to wait in milliseconds, negative to wait without timeout
+ * @return 1 if the loop was stopped by an event, 0 if the timeout expired or -1 on error
+ */
+int rasta_run_once(rasta *r, int timeout_ms);
+
+/**
+ * Get a file descriptor that becomes readable whenever the RaSTA instance has events to process,
+ * so it can be watched by an external event loop (epoll, poll, io_uring, asio, ...) instead of running rasta_run.
+ * Call rasta_process_events whenever it is readable.
+ * @param rasta the user configuration of the local RaSTA instance
+ * @return the file descriptor (owned by the RaSTA instance) or -1 if the library was built without epoll support
+ */
+int rasta_get_fd(rasta *r);
+
+/**
+ * Process all pending events of a RaSTA instance without waiting
+ * @param rasta the user configuration of the local RaSTA instance
+ * @return 1 if an event stopped the processing early (e.g. a message was received), 0 if everything was processed or -1 on error
+ */
+int rasta_process_events(rasta *r);
+
+/**
+ * Run the event loop of a RaSTA instance until rasta_stop is called (e.g. from an fd event added with rasta_add_fd_event)
+ * @param rasta the user configuration of the local RaSTA instance
+ * @return 0 if the loop was stopped or -1 on error
+ */
+int rasta_run(rasta *r);
+
+/**
+ * Stop the event loop started by rasta_run after the current event
+ * @param rasta the user configuration of the local RaSTA instance
+ */
+void rasta_stop(rasta *r);
+
 /**
  * Send data on a given RaSTA connection
  * @param rasta the user configuration of the local RaSTA instance
@@ -84,6 +181,48 @@ int rasta_recv(rasta *r, rasta_connection *connection, void *buf, size_t len);
  */
 int rasta_send(rasta *r, rasta_connection *connection, void *buf, size_t len);
 
+/**
+ * Reserve a buffer for a message on a given RaSTA connection, with room for the protocol headers and checksums
+ * around it. Write the message into the buffer and send it with rasta_send_commit, so the payload is not copied
+ * on its way to the socket. The message is sent as its own data PDU.
+ * @param rasta the user configuration of the local RaSTA instance
+ * @param connection the connection on which the message will be sent
+ * @param len the maximum length of the message in bytes, the redundancy PDU carrying it has to fit into 65535 bytes
+ *            including the headers, the safety code and the checksum
+ * @return the buffer to write the message to, NULL if len is too large for a single data PDU
+ */
+void *rasta_send_reserve(rasta *r, rasta_connection *connection, size_t len);
+
+/**
+ * Send a message that was written into a buffer from rasta_send_reserve. The buffer is released in any case.
+ * @param rasta the user configuration of the local RaSTA instance
+ * @param connection the connection on which to send the data
+ * @param buf the buffer returned by rasta_send_reserve
+ * @param len the length of the message, at most the reserved length
+ * @return 0 on success, -1 on error
+ */
+int rasta_send_commit(rasta *r, rasta_connection *connection, void *buf, size_t len);
+
+/**
+ * Release a buffer from rasta_send_reserve without sending it
+ * @param rasta the user configuration of the local RaSTA instance
+ * @param buf the buffer returned by rasta_send_reserve
+ */
+void rasta_send_abort(rasta *r, void *buf);
+
+/**
+ * Send data on a given RaSTA connection from any thread.
+ * The message is handed to the event loop through a lock-free queue and sent by it, unlike rasta_send this does
+ * not touch the connection state and may be called concurrently with the event loop and other producers.
+ * Messages submitted while the connection is not up are discarded. While the connection cannot send, e.g. because
+ * too many messages are unconfirmed, accepted messages wait in the queue, so a full queue reports the backpressure.
+ * @param connection the connection on which to send the data
+ * @param buf the buffer from which to read the data to be sent
+ * @param len the size of buf in bytes
+ * @return 0 if the message was queued, -1 if the queue is full or the message is too large for a single data PDU
+ */
+int rasta_submit(rasta_connection *connection, const void *buf, size_t len);
+
 /**
  * disconnect a connection on request by the user
  * @param connection the connection that should be disconnected
@@ -1,5 +1,6 @@
 #include "../headers/blake2_test.h"
 #include "../../../src/c/util/rastablake2.h"
+#include "../../../src/c/util/rastahashing.h"
 #include "../../../src/c/util/rmemory.h"
 #include <CUnit/Basic.h>
 
@@ -33,6 +34,52 @@ void testBlake2Hash() {
     rfree(result);
 }
 
+void testHashingContextKeyedState() {
+    unsigned char key[32];
+    unsigned char data[300];
+    unsigned char expected[16];
+    unsigned char result[16];
+    for (unsigned i = 0; i < sizeof(key); i++) {
+        key[i] = (unsigned char)(i * 7 + 1);
+    }
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = (unsigned char)(i * 13 + 5);
+    }
+
+    const unsigned lengths[] = {1, 28, 36, 127, 128, 129, 300};
+    rasta_hashing_context_t context;
+    rmemset(&context, 0, sizeof(context));
+
+    for (rasta_hash_algorithm algorithm = RASTA_ALGO_MD4; algorithm <= RASTA_ALGO_SIPHASH_2_4; algorithm++) {
+        context.algorithm = algorithm;
+        context.hash_length = RASTA_CHECKSUM_8B;
+        rasta_set_hash_key_variable(&context, (const char *)key, sizeof(key));
+
+        for (rasta_checksum_type hash_length = RASTA_CHECKSUM_8B; hash_length <= RASTA_CHECKSUM_16B; hash_length++) {
+            // changing the hash length after setting the key has to be picked up
+            context.hash_length = hash_length;
+            for (unsigned i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+                struct RastaByteArray view = {.bytes = data, .length = lengths[i]};
+                rmemset(expected, 0, sizeof(expected));
+                rmemset(result, 0, sizeof(result));
+
+                if (algorithm == RASTA_ALGO_MD4) {
+                    MD4_CONTEXT md4_ctx = md4InitContext(leLongToHost(&key[0]), leLongToHost(&key[4]), leLongToHost(&key[8]), leLongToHost(&key[12]));
+                    generateMD4WithVector(data, (int)lengths[i], hash_length, &md4_ctx, expected);
+                } else if (algorithm == RASTA_ALGO_BLAKE2B) {
+                    generateBlake2(data, (int)lengths[i], key, sizeof(key), hash_length, expected);
+                } else {
+                    generateSiphash24(data, (int)lengths[i], key, hash_length, expected);
+                }
+
+                rasta_calculate_hash(view, &context, result);
+                CU_ASSERT_EQUAL(0, memcmp(expected, result, hash_length * 8));
+            }
+        }
+    }
+    freeRastaByteArray(&context.key);
+}
+
 /**
  * Testing procedure copied from RFC 7693
  * https://tools.ietf.org/html/rfc7693
@@ -50,6 +50,7 @@ void check_std_config() {
     CU_ASSERT_EQUAL(cfg.values.redundancy.t_seq, 100);
     CU_ASSERT_EQUAL(cfg.values.redundancy.n_diagnose, 200);
     CU_ASSERT_EQUAL(cfg.values.redundancy.n_deferqueue_size, 4);
+    CU_ASSERT_FALSE(cfg.values.redundancy.udp_offload);
 
     // cechk general
     CU_ASSERT_EQUAL(cfg.values.general.rasta_network, 0);
@@ -83,6 +84,7 @@ void check_var_config() {
     fprintf(f, "RASTA_T_SEQ = 50\n");
     fprintf(f, "RASTA_N_DIAGNOSE = 100\n");
     fprintf(f, "RASTA_N_DEFERQUEUE_SIZE = 2\n");
+    fprintf(f, "RASTA_UDP_OFFLOAD = 1\n");
     fprintf(f, "RASTA_NETWORK = 1234\n");
     fprintf(f, "RASTA_ID = 2345\n");
 
@@ -130,6 +132,7 @@ void check_var_config() {
     CU_ASSERT_EQUAL(cfg.values.redundancy.t_seq, 50);
     CU_ASSERT_EQUAL(cfg.values.redundancy.n_diagnose, 100);
     CU_ASSERT_EQUAL(cfg.values.redundancy.n_deferqueue_size, 2);
+    CU_ASSERT_TRUE(cfg.values.redundancy.udp_offload);
 
     // cechk general
     CU_ASSERT_EQUAL(cfg.values.general.rasta_network, 1234);
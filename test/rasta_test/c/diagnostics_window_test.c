@@ -0,0 +1,67 @@
+#include "diagnostics_window_test.h"
+#include "../../src/c/util/diagnostics_window.h"
+#include <CUnit/Basic.h>
+
+void test_diagnostics_window_add_get() {
+    struct diagnostics_window window = diagnostics_window_init(10);
+    CU_ASSERT_EQUAL(window.count, 0);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 0), 0);
+
+    diagnostics_window_add(&window, 5, 50);
+    diagnostics_window_add(&window, 6, 60);
+    diagnostics_window_add(&window, 8, 80);
+
+    CU_ASSERT_EQUAL(window.count, 3);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 5), 50);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 6), 60);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 7), 0);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 8), 80);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 9), 0);
+
+    // late arrival behind the latest sequence number
+    diagnostics_window_add(&window, 7, 70);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 7), 70);
+
+    diagnostics_window_clear(&window);
+    CU_ASSERT_EQUAL(window.count, 0);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 5), 0);
+
+    diagnostics_window_destroy(&window);
+}
+
+void test_diagnostics_window_slide() {
+    // the window covers 64 sequence numbers
+    struct diagnostics_window window = diagnostics_window_init(10);
+
+    diagnostics_window_add(&window, 1, 10);
+    diagnostics_window_add(&window, 2, 20);
+    diagnostics_window_add(&window, 64, 640);
+
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 1), 10);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 64), 640);
+
+    // 65 uses the slot of 1, 1 drops out of the window
+    diagnostics_window_add(&window, 65, 650);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 1), 0);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 2), 20);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 65), 650);
+
+    // skipping ahead forgets the slots that were passed
+    diagnostics_window_add(&window, 130, 1300);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 66), 0);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 2), 0);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 130), 1300);
+
+    // too old
+    diagnostics_window_add(&window, 3, 30);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 3), 0);
+
+    // sequence numbers wrap around
+    diagnostics_window_clear(&window);
+    diagnostics_window_add(&window, 0xFFFFFFFF, 1);
+    diagnostics_window_add(&window, 0, 2);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 0xFFFFFFFF), 1);
+    CU_ASSERT_EQUAL(diagnostics_window_get_ts(&window, 0), 2);
+
+    diagnostics_window_destroy(&window);
+}
@@ -0,0 +1,296 @@
+#include "event_system_test.h"
+#include "../../src/c/rasta_connection.h"
+#include "../../src/c/rastahandle.h"
+#include "../../src/c/util/event_system.h"
+#include "../../src/c/util/rastautil.h"
+#include <CUnit/Basic.h>
+#include <rasta/rasta.h>
+#include <string.h>
+
+#ifdef USE_EPOLL
+#include <poll.h>
+#endif
+
+#define TIMER_COUNT 7
+
+struct test_timer {
+    timed_event event;
+    unsigned int id;
+};
+
+static unsigned int fired[TIMER_COUNT];
+static unsigned int fired_count;
+static unsigned int expected_count;
+
+static int fire_once(void *carry_data, int fd) {
+    (void)fd;
+    struct test_timer *timer = carry_data;
+    fired[fired_count++] = timer->id;
+    disable_timed_event(&timer->event);
+    // stop the loop when every expected timer fired
+    return fired_count == expected_count;
+}
+
+static void init_timers(event_system *ev_sys, struct test_timer *timers, const unsigned int *intervals_ms, unsigned int count) {
+    memset(ev_sys, 0, sizeof(event_system));
+    memset(timers, 0, count * sizeof(struct test_timer));
+    for (unsigned int i = 0; i < count; i++) {
+        timers[i].id = i;
+        timers[i].event.callback = fire_once;
+        timers[i].event.carry_data = &timers[i];
+        timers[i].event.interval = intervals_ms[i] * NS_PER_MS;
+        enable_timed_event(&timers[i].event);
+        add_timed_event(ev_sys, &timers[i].event);
+    }
+    fired_count = 0;
+}
+
+/**
+ * checks that every event in the timer queue knows its position and is due no earlier than its parent
+ */
+static void assert_heap(event_system *ev_sys) {
+    struct timed_event_heap_s *queue = &ev_sys->timed_event_queue;
+    for (unsigned int i = 0; i < queue->size; i++) {
+        timed_event *event = queue->events[i];
+        CU_ASSERT_EQUAL(event->queue_index, i + 1);
+        CU_ASSERT_TRUE(event->enabled);
+        if (i > 0) {
+            timed_event *parent = queue->events[(i - 1) / 2];
+            CU_ASSERT_TRUE(parent->last_call + parent->interval <= event->last_call + event->interval);
+        }
+    }
+}
+
+static void run_until_fired(event_system *ev_sys, unsigned int count) {
+    expected_count = count;
+    CU_ASSERT_EQUAL(event_system_run(ev_sys, NS_PER_S), 1);
+    CU_ASSERT_EQUAL(fired_count, count);
+    CU_ASSERT_EQUAL(ev_sys->timed_event_queue.size, 0);
+}
+
+void test_event_system_timer_order() {
+    event_system ev_sys;
+    struct test_timer timers[TIMER_COUNT];
+    const unsigned int intervals_ms[TIMER_COUNT] = {14, 6, 22, 2, 10, 18, 4};
+    init_timers(&ev_sys, timers, intervals_ms, TIMER_COUNT);
+    CU_ASSERT_EQUAL(ev_sys.timed_event_queue.size, TIMER_COUNT);
+    assert_heap(&ev_sys);
+
+    run_until_fired(&ev_sys, TIMER_COUNT);
+
+    const unsigned int expected[TIMER_COUNT] = {3, 6, 1, 4, 0, 5, 2};
+    for (unsigned int i = 0; i < TIMER_COUNT; i++) {
+        CU_ASSERT_EQUAL(fired[i], expected[i]);
+    }
+
+    event_system_destroy(&ev_sys);
+}
+
+void test_event_system_timer_remove() {
+    event_system ev_sys;
+    struct test_timer timers[TIMER_COUNT];
+    const unsigned int intervals_ms[TIMER_COUNT] = {2, 4, 6, 8, 10, 12, 14};
+    init_timers(&ev_sys, timers, intervals_ms, TIMER_COUNT);
+
+    // neither event is the root or the last one in the heap
+    CU_ASSERT_TRUE(timers[1].event.queue_index > 1 && timers[1].event.queue_index < TIMER_COUNT);
+    CU_ASSERT_TRUE(timers[4].event.queue_index > 1 && timers[4].event.queue_index < TIMER_COUNT);
+
+    disable_timed_event(&timers[1].event);
+    CU_ASSERT_EQUAL(timers[1].event.queue_index, 0);
+    assert_heap(&ev_sys);
+
+    remove_timed_event(&ev_sys, &timers[4].event);
+    CU_ASSERT_EQUAL(timers[4].event.queue_index, 0);
+    CU_ASSERT_PTR_NULL(timers[4].event.ev_sys);
+    CU_ASSERT_EQUAL(ev_sys.timed_event_queue.size, TIMER_COUNT - 2);
+    assert_heap(&ev_sys);
+
+    run_until_fired(&ev_sys, TIMER_COUNT - 2);
+
+    const unsigned int expected[TIMER_COUNT - 2] = {0, 2, 3, 5, 6};
+    for (unsigned int i = 0; i < TIMER_COUNT - 2; i++) {
+        CU_ASSERT_EQUAL(fired[i], expected[i]);
+    }
+
+    event_system_destroy(&ev_sys);
+}
+
+void test_event_system_timer_reschedule() {
+    event_system ev_sys;
+    struct test_timer timers[5];
+    const unsigned int intervals_ms[5] = {4, 8, 12, 16, 20};
+    init_timers(&ev_sys, timers, intervals_ms, 5);
+    CU_ASSERT_EQUAL(ev_sys.timed_event_queue.events[0], &timers[0].event);
+
+    // the last event becomes due first
+    timers[4].event.interval = 2 * NS_PER_MS;
+    reschedule_event(&timers[4].event);
+    CU_ASSERT_EQUAL(ev_sys.timed_event_queue.events[0], &timers[4].event);
+    assert_heap(&ev_sys);
+
+    // the first event becomes due last
+    timers[0].event.interval = 24 * NS_PER_MS;
+    reschedule_event(&timers[0].event);
+    assert_heap(&ev_sys);
+
+    run_until_fired(&ev_sys, 5);
+
+    const unsigned int expected[5] = {4, 1, 2, 3, 0};
+    for (unsigned int i = 0; i < 5; i++) {
+        CU_ASSERT_EQUAL(fired[i], expected[i]);
+    }
+
+    event_system_destroy(&ev_sys);
+}
+
+#define PHASE_FIRINGS 4
+
+static uint64_t phase_last_calls[PHASE_FIRINGS + 1];
+static unsigned int phase_count;
+
+static int record_phase(void *carry_data, int fd) {
+    (void)fd;
+    timed_event *event = carry_data;
+    // the deadline the event was scheduled for is last_call + interval
+    if (phase_count <= PHASE_FIRINGS) {
+        phase_last_calls[phase_count] = event->last_call;
+    }
+    phase_count++;
+    return 0;
+}
+
+/**
+ * an instance without connections, enough to drive its event loop through the public API
+ */
+static void init_test_instance(rasta *r, struct rasta_connection *connection) {
+    memset(r, 0, sizeof(rasta));
+    memset(connection, 0, sizeof(struct rasta_connection));
+    r->h.rasta_connection = connection;
+}
+
+void test_event_system_run_once_keeps_phase() {
+    rasta r;
+    struct rasta_connection connection;
+    init_test_instance(&r, &connection);
+
+    timed_event event;
+    memset(&event, 0, sizeof(timed_event));
+    event.callback = record_phase;
+    event.carry_data = &event;
+    event.interval = 20 * NS_PER_MS;
+    enable_timed_event(&event);
+    add_timed_event(&r.rasta_lib_event_system, &event);
+    uint64_t first_last_call = event.last_call;
+    phase_count = 0;
+
+    // many short calls, none of them is aligned to the interval of the timer
+    for (unsigned int i = 0; i < 100 && phase_count < PHASE_FIRINGS; i++) {
+        CU_ASSERT_EQUAL(rasta_run_once(&r, 7), 0);
+    }
+
+    // every firing is exactly one interval after the previous one, the calls did not shift the deadline
+    CU_ASSERT_EQUAL(phase_count, PHASE_FIRINGS);
+    for (unsigned int i = 0; i < PHASE_FIRINGS; i++) {
+        CU_ASSERT_EQUAL(phase_last_calls[i], first_last_call + i * event.interval);
+    }
+    CU_ASSERT_EQUAL(event.last_call, first_last_call + PHASE_FIRINGS * event.interval);
+
+    remove_timed_event(&r.rasta_lib_event_system, &event);
+    event_system_destroy(&r.rasta_lib_event_system);
+}
+
+void test_event_system_run_once_rebases_late_timer() {
+    rasta r;
+    struct rasta_connection connection;
+    init_test_instance(&r, &connection);
+
+    timed_event event;
+    memset(&event, 0, sizeof(timed_event));
+    event.callback = record_phase;
+    event.carry_data = &event;
+    event.interval = 20 * NS_PER_MS;
+    enable_timed_event(&event);
+    // e.g. the application did not run the loop for five intervals
+    event.last_call -= 5 * event.interval;
+    add_timed_event(&r.rasta_lib_event_system, &event);
+    phase_count = 0;
+
+    CU_ASSERT_EQUAL(rasta_run_once(&r, 0), 0);
+    CU_ASSERT_EQUAL(rasta_run_once(&r, 0), 0);
+
+    // the missed periods are not fired in a burst, the next deadline is one interval from now
+    CU_ASSERT_EQUAL(phase_count, 1);
+    uint64_t now = get_nanotime();
+    CU_ASSERT_TRUE(event.last_call + event.interval > now);
+    CU_ASSERT_TRUE(event.last_call <= now);
+
+    remove_timed_event(&r.rasta_lib_event_system, &event);
+    event_system_destroy(&r.rasta_lib_event_system);
+}
+
+#ifdef USE_EPOLL
+
+static int stop_processing(void *carry_data, int fd) {
+    (void)carry_data;
+    char byte;
+    ssize_t ignored = read(fd, &byte, 1);
+    (void)ignored;
+    return 1;
+}
+
+void test_event_system_fd_timer() {
+    rasta r;
+    struct rasta_connection connection;
+    init_test_instance(&r, &connection);
+
+    int fd = rasta_get_fd(&r);
+    CU_ASSERT_FATAL(fd >= 0);
+    struct pollfd pfd = {fd, POLLIN, 0};
+
+    timed_event event;
+    memset(&event, 0, sizeof(timed_event));
+    event.callback = record_phase;
+    event.carry_data = &event;
+    event.interval = 10 * NS_PER_MS;
+    enable_timed_event(&event);
+    add_timed_event(&r.rasta_lib_event_system, &event);
+    phase_count = 0;
+
+    // the fd becomes readable when the timer is due, not before
+    CU_ASSERT_EQUAL(poll(&pfd, 1, 0), 0);
+    CU_ASSERT_EQUAL(poll(&pfd, 1, 1000), 1);
+    CU_ASSERT_EQUAL(rasta_process_events(&r), 0);
+    CU_ASSERT_EQUAL(phase_count, 1);
+
+    // and again for the next period
+    CU_ASSERT_EQUAL(poll(&pfd, 1, 0), 0);
+    CU_ASSERT_EQUAL(poll(&pfd, 1, 1000), 1);
+
+    // an fd event stops the processing before the timer fires, but after the expiration may have been consumed
+    int pipe_fd[2];
+    CU_ASSERT_FATAL(pipe(pipe_fd) == 0);
+    fd_event stopper;
+    memset(&stopper, 0, sizeof(fd_event));
+    stopper.callback = stop_processing;
+    stopper.fd = pipe_fd[0];
+    enable_fd_event(&stopper);
+    rasta_add_fd_event(&r, &stopper, EV_READABLE);
+    ssize_t written = write(pipe_fd[1], "x", 1);
+    CU_ASSERT_EQUAL(written, 1);
+
+    CU_ASSERT_EQUAL(rasta_process_events(&r), 1);
+    CU_ASSERT_EQUAL(phase_count, 1);
+
+    // the timer that is still due keeps the fd readable
+    CU_ASSERT_EQUAL(poll(&pfd, 1, 1000), 1);
+    CU_ASSERT_EQUAL(rasta_process_events(&r), 0);
+    CU_ASSERT_EQUAL(phase_count, 2);
+
+    remove_timed_event(&r.rasta_lib_event_system, &event);
+    event_system_destroy(&r.rasta_lib_event_system);
+    close(pipe_fd[0]);
+    close(pipe_fd[1]);
+}
+
+#endif
@@ -3,12 +3,13 @@
 #include "../../src/c/util/rastautil.h"
 #include "../../src/c/util/rmemory.h"
 #include <CUnit/Basic.h>
+#include <limits.h>
 
 void test_push() {
     fifo_t *fifo = fifo_init(3);
     CU_ASSERT_EQUAL(fifo_get_size(fifo), 0);
-    CU_ASSERT_EQUAL(fifo->head, NULL);
-    CU_ASSERT_EQUAL(fifo->tail, NULL);
+    CU_ASSERT_EQUAL(fifo_peek(fifo), NULL);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 0), NULL);
 
     struct RastaByteArray elem;
     allocateRastaByteArray(&elem, 10);
@@ -17,10 +18,9 @@ void test_push() {
     fifo_push(fifo, &elem);
 
     CU_ASSERT_EQUAL(fifo_get_size(fifo), 1);
-    CU_ASSERT_EQUAL(fifo->head->data, &elem);
-    CU_ASSERT_EQUAL(fifo->tail->data, &elem);
-    CU_ASSERT_EQUAL(fifo->head->next, NULL);
-    CU_ASSERT_EQUAL(fifo->tail->next, NULL);
+    CU_ASSERT_EQUAL(fifo_peek(fifo), &elem);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 0), &elem);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 1), NULL);
 
     char *test_str = rmalloc(10);
     rmemcpy(test_str, "Hello", 6);
@@ -28,18 +28,17 @@ void test_push() {
     fifo_push(fifo, test_str);
 
     CU_ASSERT_EQUAL(fifo_get_size(fifo), 2);
-    CU_ASSERT_EQUAL(fifo->head->data, &elem);
-    CU_ASSERT_EQUAL(fifo->tail->data, test_str);
-    CU_ASSERT_EQUAL(fifo->head->next->data, test_str);
+    CU_ASSERT_EQUAL(fifo_peek(fifo), &elem);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 1), test_str);
 
-    struct fifo_element *struct_elem = rmalloc(sizeof(struct fifo_element));
+    struct RastaByteArray *struct_elem = rmalloc(sizeof(struct RastaByteArray));
     fifo_push(fifo, struct_elem);
 
     CU_ASSERT_EQUAL(fifo_get_size(fifo), 3);
-    CU_ASSERT_EQUAL(fifo->head->data, &elem);
-    CU_ASSERT_EQUAL(fifo->tail->data, struct_elem);
-    CU_ASSERT_EQUAL(fifo->head->next->data, test_str);
-    CU_ASSERT_EQUAL(fifo->tail->next, NULL);
+    CU_ASSERT_EQUAL(fifo_peek(fifo), &elem);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 1), test_str);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 2), struct_elem);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 3), NULL);
 
     fifo_push(fifo, &elem);
 
@@ -54,8 +53,8 @@ void test_push() {
 void test_pop() {
     fifo_t *fifo = fifo_init(3);
     CU_ASSERT_EQUAL(fifo_get_size(fifo), 0);
-    CU_ASSERT_EQUAL(fifo->head, NULL);
-    CU_ASSERT_EQUAL(fifo->tail, NULL);
+    CU_ASSERT_EQUAL(fifo_peek(fifo), NULL);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 0), NULL);
 
     int elem = 42;
 
@@ -66,33 +65,30 @@ void test_pop() {
 
     fifo_push(fifo, test_str);
 
-    struct fifo_element *struct_elem = rmalloc(sizeof(struct fifo_element));
+    struct RastaByteArray *struct_elem = rmalloc(sizeof(struct RastaByteArray));
     fifo_push(fifo, struct_elem);
 
     int res = *(int *)fifo_pop(fifo);
 
     CU_ASSERT_EQUAL(fifo_get_size(fifo), 2);
     CU_ASSERT_EQUAL(res, elem);
-    CU_ASSERT_EQUAL(fifo->head->data, test_str);
-    CU_ASSERT_EQUAL(fifo->tail->data, struct_elem);
-    CU_ASSERT_EQUAL(fifo->head->next, fifo->tail);
-    CU_ASSERT_EQUAL(fifo->tail->next, NULL);
+    CU_ASSERT_EQUAL(fifo_peek(fifo), test_str);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 1), struct_elem);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 2), NULL);
 
     char *res_str = (char *)fifo_pop(fifo);
 
     CU_ASSERT_EQUAL(fifo_get_size(fifo), 1);
     CU_ASSERT_EQUAL(res_str, test_str);
-    CU_ASSERT_EQUAL(fifo->head->data, struct_elem);
-    CU_ASSERT_EQUAL(fifo->tail->data, struct_elem);
-    CU_ASSERT_EQUAL(fifo->head->next, NULL);
-    CU_ASSERT_EQUAL(fifo->tail->next, NULL);
+    CU_ASSERT_EQUAL(fifo_peek(fifo), struct_elem);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 1), NULL);
 
-    struct fifo_element *res_struct = (struct fifo_element *)fifo_pop(fifo);
+    struct RastaByteArray *res_struct = (struct RastaByteArray *)fifo_pop(fifo);
 
     CU_ASSERT_EQUAL(fifo_get_size(fifo), 0);
     CU_ASSERT_EQUAL(res_struct, struct_elem);
-    CU_ASSERT_EQUAL(fifo->head, NULL);
-    CU_ASSERT_EQUAL(fifo->tail, NULL);
+    CU_ASSERT_EQUAL(fifo_peek(fifo), NULL);
+    CU_ASSERT_EQUAL(fifo_get(fifo, 0), NULL);
 
     void *emtpy_pop_res = fifo_pop(fifo);
     CU_ASSERT_EQUAL(emtpy_pop_res, NULL);
@@ -101,3 +97,42 @@ void test_pop() {
     rfree(test_str);
     rfree(struct_elem);
 }
+
+void test_wrap_around() {
+    fifo_t *fifo = fifo_init(3);
+    int elems[5] = {0, 1, 2, 3, 4};
+
+    // fill and drain a few times so the positions wrap around the ring buffer
+    for (int round = 0; round < 4; round++) {
+        CU_ASSERT_EQUAL(fifo_push(fifo, &elems[0]), 1);
+        CU_ASSERT_EQUAL(fifo_push(fifo, &elems[1]), 1);
+        CU_ASSERT_EQUAL(fifo_push(fifo, &elems[2]), 1);
+        CU_ASSERT_EQUAL(fifo_full(fifo), 1);
+        CU_ASSERT_EQUAL(fifo_push(fifo, &elems[3]), 0);
+
+        CU_ASSERT_EQUAL(fifo_pop(fifo), &elems[0]);
+        CU_ASSERT_EQUAL(fifo_push(fifo, &elems[4]), 1);
+
+        for (unsigned int i = 0; i < fifo_get_size(fifo); i++) {
+            CU_ASSERT_EQUAL(fifo_get(fifo, i), i < 2 ? &elems[i + 1] : &elems[4]);
+        }
+
+        CU_ASSERT_EQUAL(fifo_pop(fifo), &elems[1]);
+        CU_ASSERT_EQUAL(fifo_pop(fifo), &elems[2]);
+        CU_ASSERT_EQUAL(fifo_pop(fifo), &elems[4]);
+        CU_ASSERT_EQUAL(fifo_pop(fifo), NULL);
+    }
+
+    fifo_destroy(&fifo);
+    CU_ASSERT_EQUAL(fifo, NULL);
+}
+
+void test_oversized() {
+    CU_ASSERT_EQUAL(round_up_to_power_of_two(0), 1);
+    CU_ASSERT_EQUAL(round_up_to_power_of_two(5), 8);
+    CU_ASSERT_EQUAL(round_up_to_power_of_two(UINT_MAX / 2 + 1), UINT_MAX / 2 + 1);
+    CU_ASSERT_EQUAL(round_up_to_power_of_two(UINT_MAX / 2 + 2), 0);
+
+    // the capacity would not fit into an unsigned int
+    CU_ASSERT_PTR_NULL(fifo_init(UINT_MAX));
+}
@@ -0,0 +1,107 @@
+#include "mpsc_queue_test.h"
+#include "../../src/c/util/mpsc_queue.h"
+#include <CUnit/Basic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+
+#define PRODUCER_COUNT 4
+#define MESSAGES_PER_PRODUCER 10000
+
+void test_mpsc_queue_push_pop() {
+    mpsc_queue_t *queue = mpsc_queue_init(3);
+    CU_ASSERT_EQUAL(queue->capacity, 4);
+    CU_ASSERT_PTR_NULL(mpsc_queue_pop(queue));
+
+    int a = 1, b = 2;
+    CU_ASSERT_TRUE(mpsc_queue_push(queue, &a));
+    CU_ASSERT_TRUE(mpsc_queue_push(queue, &b));
+    CU_ASSERT_FALSE(mpsc_queue_push(queue, NULL));
+
+    CU_ASSERT_PTR_EQUAL(mpsc_queue_pop(queue), &a);
+    CU_ASSERT_PTR_EQUAL(mpsc_queue_pop(queue), &b);
+    CU_ASSERT_PTR_NULL(mpsc_queue_pop(queue));
+
+    mpsc_queue_destroy(&queue);
+    CU_ASSERT_PTR_NULL(queue);
+}
+
+void test_mpsc_queue_full() {
+    mpsc_queue_t *queue = mpsc_queue_init(2);
+    int elements[3];
+
+    // wrap around the ring a few times
+    for (int round = 0; round < 5; round++) {
+        CU_ASSERT_TRUE(mpsc_queue_push(queue, &elements[0]));
+        CU_ASSERT_TRUE(mpsc_queue_push(queue, &elements[1]));
+        CU_ASSERT_FALSE(mpsc_queue_push(queue, &elements[2]));
+
+        CU_ASSERT_PTR_EQUAL(mpsc_queue_pop(queue), &elements[0]);
+        CU_ASSERT_TRUE(mpsc_queue_push(queue, &elements[2]));
+        CU_ASSERT_PTR_EQUAL(mpsc_queue_pop(queue), &elements[1]);
+        CU_ASSERT_PTR_EQUAL(mpsc_queue_pop(queue), &elements[2]);
+        CU_ASSERT_PTR_NULL(mpsc_queue_pop(queue));
+    }
+
+    mpsc_queue_destroy(&queue);
+}
+
+struct producer_args {
+    mpsc_queue_t *queue;
+    uintptr_t producer;
+};
+
+static void *produce(void *arg) {
+    struct producer_args *args = arg;
+
+    for (uintptr_t i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+        // encode producer and sequence, 0 is not a valid element
+        void *element = (void *)(args->producer * MESSAGES_PER_PRODUCER + i + 1);
+        while (!mpsc_queue_push(args->queue, element)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+void test_mpsc_queue_multiple_producers() {
+    mpsc_queue_t *queue = mpsc_queue_init(64);
+    pthread_t producers[PRODUCER_COUNT];
+    struct producer_args args[PRODUCER_COUNT];
+    for (int i = 0; i < PRODUCER_COUNT; i++) {
+        args[i].queue = queue;
+        args[i].producer = i;
+        pthread_create(&producers[i], NULL, produce, &args[i]);
+    }
+
+    // the messages of every producer have to arrive completely and in order
+    uintptr_t next[PRODUCER_COUNT] = {0};
+    unsigned long received = 0;
+    int in_order = 1;
+    while (received < PRODUCER_COUNT * MESSAGES_PER_PRODUCER) {
+        uintptr_t element = (uintptr_t)mpsc_queue_pop(queue);
+        if (element == 0) {
+            sched_yield();
+            continue;
+        }
+        uintptr_t producer = (element - 1) / MESSAGES_PER_PRODUCER;
+        uintptr_t sequence = (element - 1) % MESSAGES_PER_PRODUCER;
+        in_order &= producer < PRODUCER_COUNT && next[producer] == sequence;
+        if (producer < PRODUCER_COUNT) {
+            next[producer] = sequence + 1;
+        }
+        received++;
+    }
+
+    for (int i = 0; i < PRODUCER_COUNT; i++) {
+        pthread_join(producers[i], NULL);
+    }
+
+    CU_ASSERT_TRUE(in_order);
+    CU_ASSERT_PTR_NULL(mpsc_queue_pop(queue));
+    mpsc_queue_destroy(&queue);
+}
+
+void test_mpsc_queue_oversized() {
+    CU_ASSERT_PTR_NULL(mpsc_queue_init(SIZE_MAX));
+}
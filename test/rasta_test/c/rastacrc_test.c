@@ -1,6 +1,8 @@
 #include "../../../src/c/util/rastacrc.h"
+#include "../../../src/c/util/rastakernels.h"
 #include "../../../src/c/util/rastautil.h"
 #include <CUnit/Basic.h>
+#include <string.h>
 #define TEST_VAL "123456789"
 
 #define OPT_B_EXPECTED 0x0E7C650A
@@ -60,6 +62,110 @@ void test_opt_e() {
     CU_ASSERT_EQUAL(res, OPT_E_EXPECTED);
 }
 
+/**
+ * bitwise CRC32C as reference for option c
+ */
+static unsigned long crc32c_reference(const unsigned char *bytes, unsigned int length) {
+    unsigned long crc = 0xFFFFFFFF;
+    while (length--) {
+        crc ^= *bytes++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+        }
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+void test_opt_c_long() {
+    struct crc_options options_c = crc_init_opt_c();
+
+    // long enough for the interleaved streams of the hardware implementation, lengths not divisible by 8
+    unsigned char bytes[2000];
+    for (unsigned int i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (unsigned char)(i * 31 + 7);
+    }
+
+    unsigned int lengths[] = {0, 1, 7, 8, 767, 768, 771, 1536, 2000};
+    for (unsigned int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        struct RastaByteArray data_to_test;
+        // start at an odd offset to test unaligned input
+        data_to_test.bytes = &bytes[lengths[i] == 2000 ? 0 : 1];
+        data_to_test.length = lengths[i];
+
+        CU_ASSERT_EQUAL(crc_calculate(&options_c, data_to_test), crc32c_reference(data_to_test.bytes, lengths[i]));
+    }
+}
+
+/**
+ * bitwise calculation of the checksum for the given @p options as reference
+ */
+static unsigned long reflect_bits(unsigned long v, int n) {
+    unsigned long result = 0;
+    for (int i = 0; i < n; i++) {
+        if (v & ((unsigned long)1 << i)) {
+            result |= (unsigned long)1 << (n - 1 - i);
+        }
+    }
+    return result;
+}
+
+static unsigned long crc_reference(struct crc_options *options, const unsigned char *bytes, unsigned int length) {
+    unsigned long crc = options->initial_optimized;
+    while (length--) {
+        unsigned long byte = options->refin ? reflect_bits(*bytes++, 8) : *bytes++;
+        crc ^= byte << (options->width - 8);
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & options->crc_high_bit) ? (crc << 1) ^ options->polynom : crc << 1;
+        }
+        crc &= options->crc_mask;
+    }
+    if (options->refout) {
+        crc = reflect_bits(crc, options->width);
+    }
+    return (crc ^ options->final_xor) & options->crc_mask;
+}
+
+void test_long_inputs() {
+    struct crc_options options[] = {crc_init_opt_b(), crc_init_opt_c(), crc_init_opt_d(), crc_init_opt_e()};
+    unsigned long expected[] = {OPT_B_EXPECTED, OPT_C_EXPECTED, OPT_D_EXPECTED, OPT_E_EXPECTED};
+
+    unsigned char bytes[1200];
+    for (unsigned int i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (unsigned char)(i * 151 + 13);
+    }
+
+    // around the lengths where the table, slicing and folding implementations take over
+    unsigned int lengths[] = {0, 1, 8, 9, 15, 63, 64, 65, 79, 80, 127, 128, 1000, 1199};
+
+    for (unsigned int o = 0; o < sizeof(options) / sizeof(options[0]); o++) {
+        // the reference has to match the check values of the options
+        CU_ASSERT_EQUAL(crc_reference(&options[o], (const unsigned char *)TEST_VAL, 9), expected[o]);
+
+        for (unsigned int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+            struct RastaByteArray data_to_test;
+            data_to_test.bytes = &bytes[1];
+            data_to_test.length = lengths[i];
+
+            CU_ASSERT_EQUAL(crc_calculate(&options[o], data_to_test), crc_reference(&options[o], data_to_test.bytes, lengths[i]));
+        }
+    }
+}
+
+void test_kernel_selection() {
+    struct crc_options options_b = crc_init_opt_b();
+    struct crc_options options_c = crc_init_opt_c();
+    struct crc_options options_custom = crc_init_opt_b();
+    options_custom.polynom = 0x04C11DB7;
+
+    // option c uses the CRC32C instruction whenever the CPU has it, the other options never do
+    CU_ASSERT_EQUAL(rasta_cpu_supports(RASTA_CPU_CRC32C), strcmp(crc_kernel_name(&options_c), "crc32c instruction") == 0);
+    CU_ASSERT_NOT_EQUAL(0, strcmp(crc_kernel_name(&options_b), "crc32c instruction"));
+    // options that are not from 6.3.6 have no kernel
+    CU_ASSERT_STRING_EQUAL("lookup table", crc_kernel_name(&options_custom));
+    // no features are always available
+    CU_ASSERT_EQUAL(1, rasta_cpu_supports(0));
+}
+
 void test_without_gen_table() {
     struct RastaByteArray data_to_test;
     allocateRastaByteArray(&data_to_test, 9);
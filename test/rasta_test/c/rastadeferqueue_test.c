@@ -3,7 +3,7 @@
 #include <CUnit/Basic.h>
 
 void test_deferqueue_init() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     CU_ASSERT_EQUAL(queue_to_test.max_count, 3);
     CU_ASSERT_EQUAL(queue_to_test.count, 0);
@@ -12,7 +12,7 @@ void test_deferqueue_init() {
 }
 
 void test_deferqueue_destroy() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 1;
@@ -26,7 +26,7 @@ void test_deferqueue_destroy() {
 }
 
 void test_deferqueue_add() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 1;
@@ -49,7 +49,7 @@ void test_deferqueue_add() {
 }
 
 void test_deferqueue_remove() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 1;
@@ -76,7 +76,7 @@ void test_deferqueue_remove() {
 }
 
 void test_deferqueue_add_full() {
-    struct defer_queue queue_to_test = deferqueue_init(1);
+    struct defer_queue queue_to_test = deferqueue_init(1, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 1;
@@ -97,7 +97,7 @@ void test_deferqueue_add_full() {
 }
 
 void test_deferqueue_remove_not_in_queue() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 1;
@@ -122,7 +122,7 @@ void test_deferqueue_remove_not_in_queue() {
 }
 
 void test_deferqueue_contains() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 1;
@@ -148,7 +148,7 @@ void test_deferqueue_contains() {
 }
 
 void test_deferqueue_isfull() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 1;
@@ -175,7 +175,7 @@ void test_deferqueue_isfull() {
 }
 
 void test_deferqueue_smallestseqnr() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 3;
@@ -198,7 +198,7 @@ void test_deferqueue_smallestseqnr() {
 }
 
 void test_deferqueue_get() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 3;
@@ -223,40 +223,50 @@ void test_deferqueue_get() {
     deferqueue_destroy(&queue_to_test);
 }
 
-void test_deferqueue_sorted() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+void test_deferqueue_sequence_window() {
+    struct defer_queue queue_to_test = deferqueue_init(3, 100);
 
+    // the ring has 128 slots, 300 uses the same slot as 44
     struct RastaRedundancyPacket packet;
-    packet.sequence_number = 3;
-    unsigned long ts_1 = 2;
+    packet.sequence_number = 44;
 
     struct RastaRedundancyPacket packet2;
-    packet2.sequence_number = 1;
-    unsigned long ts_2 = 3;
+    packet2.sequence_number = 300;
 
     struct RastaRedundancyPacket packet3;
-    packet3.sequence_number = 2;
-    unsigned long ts_3 = 1;
+    packet3.sequence_number = 127;
 
-    deferqueue_add(&queue_to_test, packet, ts_1);
-    deferqueue_add(&queue_to_test, packet2, ts_2);
-    deferqueue_add(&queue_to_test, packet3, ts_3);
+    struct RastaRedundancyPacket packet4;
+    packet4.sequence_number = 128;
 
-    CU_ASSERT_EQUAL(queue_to_test.elements[0].received_timestamp, 1);
-    CU_ASSERT_EQUAL(queue_to_test.elements[1].received_timestamp, 2);
-    CU_ASSERT_EQUAL(queue_to_test.elements[2].received_timestamp, 3);
+    CU_ASSERT_EQUAL(deferqueue_add(&queue_to_test, packet, 1), 1);
+    CU_ASSERT_EQUAL(deferqueue_add(&queue_to_test, packet2, 2), 0);
+    CU_ASSERT_EQUAL(deferqueue_contains(&queue_to_test, 300), 0);
 
-    // remove the first element: last element is move to first place
-    deferqueue_remove(&queue_to_test, 2);
+    // the window wraps around the end of the ring
+    CU_ASSERT_EQUAL(deferqueue_add(&queue_to_test, packet3, 3), 1);
+    CU_ASSERT_EQUAL(deferqueue_add(&queue_to_test, packet4, 4), 1);
+    CU_ASSERT_EQUAL(deferqueue_get_ts(&queue_to_test, 127), 3);
+    CU_ASSERT_EQUAL(deferqueue_get_ts(&queue_to_test, 128), 4);
+
+    // removing an element moves the last one, it has to stay reachable by its sequence number
+    deferqueue_remove(&queue_to_test, 44);
+    CU_ASSERT_EQUAL(queue_to_test.count, 2);
+    CU_ASSERT_EQUAL(deferqueue_get(&queue_to_test, 128).sequence_number, 128);
+
+    // the slot is free again
+    CU_ASSERT_EQUAL(deferqueue_add(&queue_to_test, packet2, 5), 1);
+    CU_ASSERT_EQUAL(deferqueue_get_ts(&queue_to_test, 300), 5);
 
-    CU_ASSERT_EQUAL(queue_to_test.elements[0].received_timestamp, 2);
-    CU_ASSERT_EQUAL(queue_to_test.elements[1].received_timestamp, 3);
+    deferqueue_clear(&queue_to_test);
+    CU_ASSERT_EQUAL(deferqueue_contains(&queue_to_test, 127), 0);
+    CU_ASSERT_EQUAL(deferqueue_add(&queue_to_test, packet3, 6), 1);
 
     deferqueue_destroy(&queue_to_test);
 }
 
 void test_deferqueue_clear() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 3;
@@ -277,7 +287,7 @@ void test_deferqueue_clear() {
 }
 
 void test_deferqueue_get_ts() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 3;
@@ -297,7 +307,7 @@ void test_deferqueue_get_ts() {
 }
 
 void test_deferqueue_get_ts_doesnt_contain() {
-    struct defer_queue queue_to_test = deferqueue_init(3);
+    struct defer_queue queue_to_test = deferqueue_init(3, 30);
 
     struct RastaRedundancyPacket packet;
     packet.sequence_number = 3;
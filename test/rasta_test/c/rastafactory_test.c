@@ -244,14 +244,15 @@ void testCreateRedundancyPacket() {
 
     // crc opt b = 32bit/4byte width
     struct RastaRedundancyPacket pdu_to_test;
-    createRedundancyPacket(1, &inner_test, crc_init_opt_b(), &pdu_to_test);
+    struct crc_options options = crc_init_opt_b();
+    createRedundancyPacket(1, &inner_test, &options, &pdu_to_test);
 
     unsigned short expected_len = 8 + 10 + 4;
 
     CU_ASSERT_EQUAL(pdu_to_test.reserve, 0x0000);
     CU_ASSERT_EQUAL(pdu_to_test.checksum_correct, 1);
     CU_ASSERT_EQUAL(pdu_to_test.data.sequence_number, 42);
-    CU_ASSERT_EQUAL(pdu_to_test.checksum_type.width, crc_init_opt_b().width);
+    CU_ASSERT_EQUAL(pdu_to_test.checksum_type->width, crc_init_opt_b().width);
     CU_ASSERT_EQUAL(pdu_to_test.length, expected_len);
 }
 
@@ -263,13 +264,14 @@ void testCreateRedundancyPacketNoChecksum() {
 
     // crc opt a = no crc / 0 bit width
     struct RastaRedundancyPacket pdu_to_test;
-    createRedundancyPacket(1, &inner_test, crc_init_opt_a(), &pdu_to_test);
+    struct crc_options options = crc_init_opt_a();
+    createRedundancyPacket(1, &inner_test, &options, &pdu_to_test);
 
     unsigned short expected_len = 8 + 10 + 0;
 
     CU_ASSERT_EQUAL(pdu_to_test.reserve, 0x0000);
     CU_ASSERT_EQUAL(pdu_to_test.checksum_correct, 1);
     CU_ASSERT_EQUAL(pdu_to_test.data.sequence_number, 42);
-    CU_ASSERT_EQUAL(pdu_to_test.checksum_type.width, crc_init_opt_a().width);
+    CU_ASSERT_EQUAL(pdu_to_test.checksum_type->width, crc_init_opt_a().width);
     CU_ASSERT_EQUAL(pdu_to_test.length, expected_len);
 }
@@ -5,6 +5,7 @@
 #include <CUnit/Basic.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #include "../../../src/c/util/rastamd4.h"
@@ -154,3 +155,42 @@ void testRastaMD4Sample() {
         CU_ASSERT_EQUAL(md4[i], calc_md4[i]);
     }
 }
+
+void testMD4Batch() {
+    unsigned char data[11][300];
+    unsigned char *messages[11];
+    unsigned long lengths[11];
+    unsigned char results[11][16];
+    unsigned char *result_pointers[11];
+    const unsigned long message_lengths[11] = {0, 1, 28, 55, 56, 63, 64, 119, 120, 128, 300};
+
+    for (unsigned int i = 0; i < 11; i++) {
+        for (unsigned int j = 0; j < sizeof(data[i]); j++) {
+            data[i][j] = (unsigned char)(i * 31 + j * 7);
+        }
+        messages[i] = data[i];
+        result_pointers[i] = results[i];
+    }
+
+    const MD4_CONTEXT context = md4InitContext(0x01234567, 0x89abcdef, 0xfedcba98, 0x76543210);
+
+    // every number of messages, so that all lanes and the remainder are used
+    for (unsigned int count = 1; count <= 11; count++) {
+        for (int type = 1; type <= 2; type++) {
+            for (unsigned int i = 0; i < count; i++) {
+                // messages of different lengths end in different blocks
+                lengths[i] = message_lengths[(i + count) % 11];
+            }
+            memset(results, 0, sizeof(results));
+
+            generateMD4Batch(messages, lengths, count, type, &context, result_pointers);
+
+            for (unsigned int i = 0; i < count; i++) {
+                unsigned char expected[16] = {0};
+                MD4_CONTEXT single = context;
+                generateMD4WithVector(messages[i], (int)lengths[i], type, &single, expected);
+                CU_ASSERT_EQUAL(0, memcmp(expected, results[i], type * 8));
+            }
+        }
+    }
+}
@@ -108,14 +108,18 @@ void testRedundancyConversionWithCrcChecksumCorrect() {
     packet_to_test.length = 50;
     packet_to_test.reserve = 0;
     packet_to_test.sequence_number = 1;
-    packet_to_test.checksum_type = crc_init_opt_b();
+    struct crc_options options = crc_init_opt_b();
+    packet_to_test.checksum_type = &options;
     packet_to_test.data = r;
 
     struct RastaByteArray convertedToBytes;
     convertedToBytes = rastaRedundancyPacketToBytes(&packet_to_test, &context);
 
+    rasta_decode_context_t decode_context;
+    rasta_decode_context_init(&decode_context, &options, &context);
+
     struct RastaRedundancyPacket convertedFromBytes;
-    bytesToRastaRedundancyPacket(convertedToBytes, crc_init_opt_b(), &context, &convertedFromBytes);
+    bytesToRastaRedundancyPacket(convertedToBytes, &decode_context, &convertedFromBytes);
 
     CU_ASSERT_EQUAL(convertedFromBytes.length, packet_to_test.length);
     CU_ASSERT_EQUAL(convertedFromBytes.reserve, packet_to_test.reserve);
@@ -173,14 +177,18 @@ void testRedundancyConversionWithoutChecksum() {
     packet_to_test.length = 50;
     packet_to_test.reserve = 0;
     packet_to_test.sequence_number = 1;
-    packet_to_test.checksum_type = crc_init_opt_a();
+    struct crc_options options = crc_init_opt_a();
+    packet_to_test.checksum_type = &options;
     packet_to_test.data = r;
 
     struct RastaByteArray convertedToBytes;
     convertedToBytes = rastaRedundancyPacketToBytes(&packet_to_test, &context);
 
+    rasta_decode_context_t decode_context;
+    rasta_decode_context_init(&decode_context, &options, &context);
+
     struct RastaRedundancyPacket convertedFromBytes;
-    bytesToRastaRedundancyPacket(convertedToBytes, crc_init_opt_a(), &context, &convertedFromBytes);
+    bytesToRastaRedundancyPacket(convertedToBytes, &decode_context, &convertedFromBytes);
 
     CU_ASSERT_EQUAL(convertedFromBytes.length, packet_to_test.length);
     CU_ASSERT_EQUAL(convertedFromBytes.reserve, packet_to_test.reserve);
@@ -237,7 +245,8 @@ void testRedundancyConversionIncorrectChecksum() {
     packet_to_test.length = 50;
     packet_to_test.reserve = 0;
     packet_to_test.sequence_number = 1;
-    packet_to_test.checksum_type = crc_init_opt_b();
+    struct crc_options options = crc_init_opt_b();
+    packet_to_test.checksum_type = &options;
     packet_to_test.data = r;
 
     struct RastaByteArray convertedToBytes;
@@ -246,8 +255,11 @@ void testRedundancyConversionIncorrectChecksum() {
     // simulate error in packet transmission
     convertedToBytes.bytes[16] = 0x42;
 
+    rasta_decode_context_t decode_context;
+    rasta_decode_context_init(&decode_context, &options, &context);
+
     struct RastaRedundancyPacket convertedFromBytes;
-    bytesToRastaRedundancyPacket(convertedToBytes, crc_init_opt_b(), &context, &convertedFromBytes);
+    bytesToRastaRedundancyPacket(convertedToBytes, &decode_context, &convertedFromBytes);
 
     // check if internal packet checksum is incorrect
     CU_ASSERT_EQUAL(convertedFromBytes.data.checksum_correct, 0);
@@ -0,0 +1,121 @@
+#include "reassembly_buffer_test.h"
+#include "../../src/c/util/reassembly_buffer.h"
+#include <CUnit/Basic.h>
+#include <string.h>
+
+static void write_bytes(reassembly_buffer_t *buffer, const unsigned char *bytes, unsigned int length) {
+    // the free space may wrap around, so the bytes may have to be written in two parts
+    unsigned int written = 0;
+    while (written < length) {
+        unsigned int available;
+        unsigned char *area = reassembly_buffer_write_area(buffer, length - written, &available);
+        unsigned int n = length - written < available ? length - written : available;
+        memcpy(area, &bytes[written], n);
+        reassembly_buffer_commit(buffer, n);
+        written += n;
+    }
+}
+
+static void write_pdu(reassembly_buffer_t *buffer, unsigned int length, unsigned char fill) {
+    unsigned char pdu[300];
+    memset(pdu, fill, sizeof(pdu));
+    pdu[0] = length & 0xFF;
+    pdu[1] = (length >> 8) & 0xFF;
+    write_bytes(buffer, pdu, length);
+}
+
+void test_reassembly_buffer_partial() {
+    reassembly_buffer_t buffer;
+    reassembly_buffer_init(&buffer);
+    unsigned char *pdu;
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 0);
+    CU_ASSERT_EQUAL(reassembly_buffer_missing(&buffer), 2);
+
+    // only the length prefix of a PDU
+    unsigned int available;
+    unsigned char *area = reassembly_buffer_write_area(&buffer, 64, &available);
+    CU_ASSERT_TRUE(available >= 64);
+    area[0] = 6;
+    area[1] = 0;
+    reassembly_buffer_commit(&buffer, 2);
+    CU_ASSERT_EQUAL(reassembly_buffer_missing(&buffer), 4);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 0);
+
+    // the rest of the PDU and another complete one are handed out one by one
+    area = reassembly_buffer_write_area(&buffer, 1, &available);
+    memset(area, 7, 4);
+    reassembly_buffer_commit(&buffer, 4);
+    write_pdu(&buffer, 5, 8);
+    CU_ASSERT_EQUAL(reassembly_buffer_missing(&buffer), 0);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 6);
+    CU_ASSERT_EQUAL(pdu[0], 6);
+    CU_ASSERT_EQUAL(pdu[5], 7);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 5);
+    CU_ASSERT_EQUAL(pdu[0], 5);
+    CU_ASSERT_EQUAL(pdu[4], 8);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 0);
+
+    // a length prefix below the minimum cannot be parsed
+    write_pdu(&buffer, 3, 0);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), -1);
+    reassembly_buffer_clear(&buffer);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 0);
+
+    reassembly_buffer_destroy(&buffer);
+    CU_ASSERT_PTR_NULL(buffer.data);
+}
+
+void test_reassembly_buffer_wrap_around() {
+    reassembly_buffer_t buffer;
+    reassembly_buffer_init(&buffer);
+    unsigned int available;
+    reassembly_buffer_write_area(&buffer, 32, &available);
+    CU_ASSERT_EQUAL(buffer.capacity, 32);
+
+    unsigned char bytes[12];
+    memset(bytes, 4, sizeof(bytes));
+    bytes[0] = 12;
+    bytes[1] = 0;
+
+    // keep a partial PDU at the end of the ring
+    unsigned char *pdu;
+    write_pdu(&buffer, 20, 1);
+    write_pdu(&buffer, 6, 3);
+    write_bytes(&buffer, bytes, 4);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 20);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 6);
+    CU_ASSERT_EQUAL(pdu[5], 3);
+
+    // the rest of the PDU wraps around, it is handed out as a copy
+    write_bytes(&buffer, &bytes[4], 8);
+    CU_ASSERT_EQUAL(buffer.capacity, 32);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 12);
+    CU_ASSERT_PTR_EQUAL(pdu, buffer.linear);
+    CU_ASSERT_EQUAL(pdu[0], 12);
+    CU_ASSERT_EQUAL(pdu[2], 4);
+    CU_ASSERT_EQUAL(pdu[11], 4);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 0);
+
+    reassembly_buffer_destroy(&buffer);
+}
+
+void test_reassembly_buffer_grow() {
+    reassembly_buffer_t buffer;
+    reassembly_buffer_init(&buffer);
+    unsigned int available;
+    reassembly_buffer_write_area(&buffer, 16, &available);
+    CU_ASSERT_EQUAL(buffer.capacity, 16);
+
+    // a PDU that is larger than the buffer, the buffered bytes are kept when the buffer grows
+    unsigned char *pdu;
+    write_pdu(&buffer, 10, 1);
+    write_pdu(&buffer, 200, 2);
+    CU_ASSERT_EQUAL(buffer.capacity, 256);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 10);
+    CU_ASSERT_EQUAL(pdu[9], 1);
+    CU_ASSERT_EQUAL(reassembly_buffer_next(&buffer, 4, &pdu), 200);
+    CU_ASSERT_EQUAL(pdu[0], 200);
+    CU_ASSERT_EQUAL(pdu[199], 2);
+
+    reassembly_buffer_destroy(&buffer);
+}
@@ -4,8 +4,11 @@
 // INCLUDE TESTS
 #include "blake2_test.h"
 #include "config_test.h"
+#include "diagnostics_window_test.h"
 #include "dictionary_test.h"
+#include "event_system_test.h"
 #include "fifo_test.h"
+#include "mpsc_queue_test.h"
 #include "opaque_test.h"
 #include "rastacrc_test.h"
 #include "rastadeferqueue_test.h"
@@ -13,7 +16,12 @@
 #include "rastamd4_test.h"
 #include "rastamodule_test.h"
 #include "redundancy_channel_test.h"
+#include "reassembly_buffer_test.h"
+#include "send_buffer_test.h"
+#include "retransmission_store_test.h"
+#include "rmemory_test.h"
 #include "safety_retransmission_test.h"
+#include "udp_batch_test.h"
 
 int suite_init(void) {
     return 0;
@@ -30,12 +38,16 @@ void cunit_register() {
     // MD4 tests
     CU_add_test(pSuiteRasta, "testMD4function", testMD4function);
     CU_add_test(pSuiteRasta, "testRastaMD4Sample", testRastaMD4Sample);
+    CU_add_test(pSuiteRasta, "testMD4Batch", testMD4Batch);
 
     // Tests for the crc module
     CU_add_test(pSuiteRasta, "test_opt_b", test_opt_b);
     CU_add_test(pSuiteRasta, "test_opt_c", test_opt_c);
     CU_add_test(pSuiteRasta, "test_opt_d", test_opt_d);
     CU_add_test(pSuiteRasta, "test_opt_e", test_opt_e);
+    CU_add_test(pSuiteRasta, "test_opt_c_long", test_opt_c_long);
+    CU_add_test(pSuiteRasta, "test_long_inputs", test_long_inputs);
+    CU_add_test(pSuiteRasta, "test_kernel_selection", test_kernel_selection);
     CU_add_test(pSuiteRasta, "test_without_gen_table", test_without_gen_table);
 
     // Tests for rastafactory
@@ -69,7 +81,7 @@ void cunit_register() {
     CU_add_test(pSuiteRasta, "test_deferqueue_destroy", test_deferqueue_destroy);
     CU_add_test(pSuiteRasta, "test_deferqueue_isfull", test_deferqueue_isfull);
     CU_add_test(pSuiteRasta, "test_deferqueue_get", test_deferqueue_get);
-    CU_add_test(pSuiteRasta, "test_deferqueue_sorted", test_deferqueue_sorted);
+    CU_add_test(pSuiteRasta, "test_deferqueue_sequence_window", test_deferqueue_sequence_window);
     CU_add_test(pSuiteRasta, "test_deferqueue_get_ts", test_deferqueue_get_ts);
     CU_add_test(pSuiteRasta, "test_deferqueue_clear", test_deferqueue_clear);
     CU_add_test(pSuiteRasta, "test_deferqueue_get_ts_doesnt_contain", test_deferqueue_get_ts_doesnt_contain);
@@ -77,17 +89,67 @@ void cunit_register() {
     // Tests for the FIFO
     CU_add_test(pSuiteRasta, "test_push", test_push);
     CU_add_test(pSuiteRasta, "test_pop", test_pop);
+    CU_add_test(pSuiteRasta, "test_wrap_around", test_wrap_around);
+    CU_add_test(pSuiteRasta, "test_oversized", test_oversized);
+
+    // Tests for the retransmission store
+    CU_add_test(pSuiteRasta, "test_retransmission_store_push_pop", test_retransmission_store_push_pop);
+    CU_add_test(pSuiteRasta, "test_retransmission_store_confirm", test_retransmission_store_confirm);
+    CU_add_test(pSuiteRasta, "test_retransmission_store_wrap_around", test_retransmission_store_wrap_around);
+
+    // Tests for the reassembly buffer
+    CU_add_test(pSuiteRasta, "test_reassembly_buffer_partial", test_reassembly_buffer_partial);
+    CU_add_test(pSuiteRasta, "test_reassembly_buffer_wrap_around", test_reassembly_buffer_wrap_around);
+    CU_add_test(pSuiteRasta, "test_reassembly_buffer_grow", test_reassembly_buffer_grow);
+
+    // Tests for the send buffer
+    CU_add_test(pSuiteRasta, "test_send_buffer_push_consume", test_send_buffer_push_consume);
+    CU_add_test(pSuiteRasta, "test_send_buffer_wrap_around", test_send_buffer_wrap_around);
+
+    // Tests for the diagnostics window
+    CU_add_test(pSuiteRasta, "test_diagnostics_window_add_get", test_diagnostics_window_add_get);
+    CU_add_test(pSuiteRasta, "test_diagnostics_window_slide", test_diagnostics_window_slide);
+
+    // Tests for the event system
+    CU_add_test(pSuiteRasta, "test_event_system_timer_order", test_event_system_timer_order);
+    CU_add_test(pSuiteRasta, "test_event_system_timer_remove", test_event_system_timer_remove);
+    CU_add_test(pSuiteRasta, "test_event_system_timer_reschedule", test_event_system_timer_reschedule);
+    CU_add_test(pSuiteRasta, "test_event_system_run_once_keeps_phase", test_event_system_run_once_keeps_phase);
+    CU_add_test(pSuiteRasta, "test_event_system_run_once_rebases_late_timer", test_event_system_run_once_rebases_late_timer);
+#ifdef USE_EPOLL
+    CU_add_test(pSuiteRasta, "test_event_system_fd_timer", test_event_system_fd_timer);
+#endif
+
+    // Tests for the MPSC queue
+    CU_add_test(pSuiteRasta, "test_mpsc_queue_push_pop", test_mpsc_queue_push_pop);
+    CU_add_test(pSuiteRasta, "test_mpsc_queue_full", test_mpsc_queue_full);
+    CU_add_test(pSuiteRasta, "test_mpsc_queue_multiple_producers", test_mpsc_queue_multiple_producers);
+    CU_add_test(pSuiteRasta, "test_mpsc_queue_oversized", test_mpsc_queue_oversized);
+
+    // Tests for the buffer pool and allocator hooks
+    CU_add_test(pSuiteRasta, "test_rmem_pool_reuse", test_rmem_pool_reuse);
+    CU_add_test(pSuiteRasta, "test_rmem_pool_oversized", test_rmem_pool_oversized);
+    CU_add_test(pSuiteRasta, "test_rmem_pool_destroy_in_use", test_rmem_pool_destroy_in_use);
+    CU_add_test(pSuiteRasta, "test_rmem_context_allocator", test_rmem_context_allocator);
+    CU_add_test(pSuiteRasta, "test_rmem_scope", test_rmem_scope);
 
     // Tests for BLAKE2 hashes
     CU_add_test(pSuiteRasta, "testBlake2Hash", testBlake2Hash);
+    CU_add_test(pSuiteRasta, "testHashingContextKeyedState", testHashingContextKeyedState);
 
     // Tests for Safety and Retransmission layer
     CU_add_test(pSuiteRasta, "test_sr_retransmit_data_shouldSendFinalHeartbeat", test_sr_retransmit_data_shouldSendFinalHeartbeat);
     CU_add_test(pSuiteRasta, "test_sr_retransmit_data_shouldRetransmitPackage", test_sr_retransmit_data_shouldRetransmitPackage);
     CU_add_test(pSuiteRasta, "test_sr_handle_conreq_shouldInitializeSequenceNumberFromConfig", test_sr_handle_conreq_shouldInitializeSequenceNumberFromConfig);
+    CU_add_test(pSuiteRasta, "test_sr_reserve_message_shouldRejectOversizedMessage", test_sr_reserve_message_shouldRejectOversizedMessage);
+    CU_add_test(pSuiteRasta, "test_sr_queue_submitted_shouldKeepMessagesWhileRetransmissionStoreIsFull", test_sr_queue_submitted_shouldKeepMessagesWhileRetransmissionStoreIsFull);
 
     CU_add_test(pSuiteRasta, "test_redundancy_channel", test_redundancy_channel);
 
+    // Tests for the UDP transport
+    CU_add_test(pSuiteRasta, "test_udp_batch_send_receive", test_udp_batch_send_receive);
+    CU_add_test(pSuiteRasta, "test_udp_batch_offload", test_udp_batch_offload);
+
     // Tests for OPAQUE
 #ifdef ENABLE_OPAQUE
     CU_add_test(pSuiteRasta, "opaque_wrapper_test", opaque_wrapper_test);
@@ -0,0 +1,74 @@
+#include "retransmission_store_test.h"
+#include "../../src/c/util/retransmission_store.h"
+#include <CUnit/Basic.h>
+
+static void push_entry(retransmission_store_t *store, uint32_t sequence_number) {
+    struct RastaByteArray buffer;
+    allocateRastaByteArray(&buffer, 8 + 36);
+    buffer.bytes[8] = (unsigned char)sequence_number;
+    retransmission_store_push(store, sequence_number, sequence_number * 10, buffer, 8, 36);
+}
+
+void test_retransmission_store_push_pop() {
+    retransmission_store_t *store = retransmission_store_init(2);
+    CU_ASSERT_EQUAL(retransmission_store_size(store), 0);
+    CU_ASSERT_PTR_NULL(retransmission_store_get(store, 0));
+
+    push_entry(store, 5);
+    push_entry(store, 6);
+    CU_ASSERT_TRUE(retransmission_store_full(store));
+
+    struct RastaByteArray buffer;
+    allocateRastaByteArray(&buffer, 1);
+    CU_ASSERT_FALSE(retransmission_store_push(store, 7, 0, buffer, 0, 1));
+    freeRastaByteArray(&buffer);
+
+    struct retransmission_entry *entry = retransmission_store_get(store, 1);
+    CU_ASSERT_EQUAL(entry->sequence_number, 6);
+    CU_ASSERT_EQUAL(entry->timestamp, 60);
+    CU_ASSERT_EQUAL(entry->offset, 8);
+    CU_ASSERT_EQUAL(entry->length, 36);
+    CU_ASSERT_EQUAL(entry->buffer.bytes[entry->offset], 6);
+
+    struct retransmission_entry popped;
+    CU_ASSERT_TRUE(retransmission_store_pop(store, &popped));
+    CU_ASSERT_EQUAL(popped.sequence_number, 5);
+    freeRastaByteArray(&popped.buffer);
+    CU_ASSERT_EQUAL(retransmission_store_size(store), 1);
+
+    retransmission_store_destroy(&store);
+    CU_ASSERT_PTR_NULL(store);
+}
+
+void test_retransmission_store_confirm() {
+    retransmission_store_t *store = retransmission_store_init(8);
+    for (uint32_t sn = 10; sn < 15; sn++) {
+        push_entry(store, sn);
+    }
+
+    CU_ASSERT_EQUAL(retransmission_store_confirm(store, 12), 3);
+    CU_ASSERT_EQUAL(retransmission_store_size(store), 2);
+    CU_ASSERT_EQUAL(retransmission_store_get(store, 0)->sequence_number, 13);
+
+    // an unknown sequence number confirms everything
+    CU_ASSERT_EQUAL(retransmission_store_confirm(store, 100), 2);
+    CU_ASSERT_EQUAL(retransmission_store_size(store), 0);
+    CU_ASSERT_EQUAL(retransmission_store_confirm(store, 100), 0);
+
+    retransmission_store_destroy(&store);
+}
+
+void test_retransmission_store_wrap_around() {
+    retransmission_store_t *store = retransmission_store_init(3);
+    uint32_t next = 0;
+    for (unsigned int round = 0; round < 10; round++) {
+        while (!retransmission_store_full(store)) {
+            push_entry(store, next++);
+        }
+        CU_ASSERT_EQUAL(retransmission_store_get(store, 2)->sequence_number, next - 1);
+        CU_ASSERT_EQUAL(retransmission_store_confirm(store, next - 2), 2);
+        CU_ASSERT_EQUAL(retransmission_store_get(store, 0)->sequence_number, next - 1);
+    }
+
+    retransmission_store_destroy(&store);
+}
@@ -0,0 +1,145 @@
+#include "rmemory_test.h"
+#include "../../src/c/util/rmemory.h"
+#include <CUnit/Basic.h>
+#include <stdlib.h>
+
+void test_rmem_pool_reuse() {
+    unsigned int sizes[] = {256, 16, 64};
+    rmem_pool_t *pool = rmem_pool_init(sizes, 3);
+
+    void *a = rmem_pool_alloc(pool, 10);
+    void *b = rmem_pool_alloc(pool, 10);
+    CU_ASSERT_PTR_NOT_NULL(a);
+    CU_ASSERT_PTR_NOT_NULL(b);
+    CU_ASSERT_PTR_NOT_EQUAL(a, b);
+
+    // freed blocks are handed out again
+    rmem_pool_free(a);
+    CU_ASSERT_PTR_EQUAL(rmem_pool_alloc(pool, 16), a);
+
+    // a larger size class does not share blocks with the smaller one
+    void *c = rmem_pool_alloc(pool, 100);
+    CU_ASSERT_PTR_NOT_EQUAL(c, a);
+    CU_ASSERT_PTR_NOT_EQUAL(c, b);
+
+    rmem_pool_free(a);
+    rmem_pool_free(b);
+    rmem_pool_free(c);
+    rmem_pool_destroy(&pool);
+    CU_ASSERT_PTR_NULL(pool);
+}
+
+void test_rmem_pool_oversized() {
+    unsigned int sizes[] = {32};
+    rmem_pool_t *pool = rmem_pool_init(sizes, 1);
+
+    unsigned char *data = rmem_pool_alloc(pool, 1000);
+    CU_ASSERT_PTR_NOT_NULL(data);
+    data[999] = 1;
+    rmem_pool_free(data);
+
+    // without a pool the memory comes from the heap
+    data = rmem_pool_alloc(NULL, 8);
+    CU_ASSERT_PTR_NOT_NULL(data);
+    rmem_pool_free(data);
+    rmem_pool_free(NULL);
+
+    rmem_pool_destroy(&pool);
+}
+
+void test_rmem_pool_destroy_in_use() {
+    unsigned int sizes[] = {32};
+    rmem_pool_t *pool = rmem_pool_init(sizes, 1);
+    CU_ASSERT_PTR_NULL(rmem_pool_activate(pool));
+    CU_ASSERT_PTR_EQUAL(rmem_pool_active(), pool);
+
+    void *data = rmem_pool_alloc(pool, 32);
+    rmem_pool_destroy(&pool);
+    CU_ASSERT_PTR_NULL(rmem_pool_active());
+
+    // the pool is released together with its last block
+    rmem_pool_free(data);
+}
+
+struct counting_allocator {
+    unsigned int allocations;
+    unsigned int frees;
+};
+
+static void *counting_alloc(void *user_data, size_t size, rasta_memory_tag tag) {
+    (void)tag;
+    ((struct counting_allocator *)user_data)->allocations++;
+    return malloc(size);
+}
+
+static void *counting_realloc(void *user_data, void *ptr, size_t size, rasta_memory_tag tag) {
+    (void)tag;
+    ((struct counting_allocator *)user_data)->allocations++;
+    return realloc(ptr, size);
+}
+
+static void counting_free(void *user_data, void *ptr) {
+    ((struct counting_allocator *)user_data)->frees++;
+    free(ptr);
+}
+
+void test_rmem_context_allocator() {
+    struct counting_allocator counter = {0, 0};
+    rasta_allocator allocator = {counting_alloc, counting_realloc, counting_free, &counter};
+    rmem_context_t *context = rmem_context_init(&allocator);
+    CU_ASSERT_EQUAL(counter.allocations, 1);
+
+    CU_ASSERT_PTR_NULL(rmem_context_activate(context));
+    void *data = rmalloc_tagged(RASTA_MEMORY_TAG_FIFO, 100);
+    data = rrealloc_tagged(RASTA_MEMORY_TAG_FIFO, data, 200);
+    rfree(data);
+    rfree(rmalloc(10));
+    CU_ASSERT_EQUAL(counter.allocations, 4);
+    CU_ASSERT_EQUAL(counter.frees, 2);
+
+    rasta_memory_stats stats;
+    rmem_context_stats(context, &stats);
+    CU_ASSERT_EQUAL(stats.calls[RASTA_MEMORY_TAG_FIFO], 2);
+    CU_ASSERT_EQUAL(stats.bytes[RASTA_MEMORY_TAG_FIFO], 300);
+    CU_ASSERT_EQUAL(stats.calls[RASTA_MEMORY_TAG_OTHER], 2);
+    CU_ASSERT_EQUAL(stats.calls[RASTA_MEMORY_TAG_PACKET], 0);
+
+    rmem_context_destroy(&context);
+    CU_ASSERT_PTR_NULL(context);
+    CU_ASSERT_EQUAL(counter.frees, 3);
+
+    // without an active context memory comes from the C library
+    rfree(rmalloc(10));
+    CU_ASSERT_EQUAL(counter.allocations, 4);
+}
+
+void test_rmem_scope() {
+    rmem_context_t *outer_context = rmem_context_init(NULL);
+    rmem_context_t *inner_context = rmem_context_init(NULL);
+    unsigned int sizes[] = {64};
+    rmem_pool_t *outer_pool = rmem_pool_init(sizes, 1);
+    rmem_pool_t *inner_pool = rmem_pool_init(sizes, 1);
+
+    rmem_scope_t outer = rmem_scope_enter(outer_context, outer_pool);
+    CU_ASSERT_PTR_NULL(outer.context);
+    CU_ASSERT_PTR_NULL(outer.pool);
+
+    // e.g. a callback of one instance that calls into another one
+    rmem_scope_t inner = rmem_scope_enter(inner_context, inner_pool);
+    CU_ASSERT_PTR_EQUAL(inner.context, outer_context);
+    CU_ASSERT_PTR_EQUAL(inner.pool, outer_pool);
+    CU_ASSERT_PTR_EQUAL(rmem_pool_active(), inner_pool);
+
+    rmem_scope_leave(inner);
+    CU_ASSERT_PTR_EQUAL(rmem_pool_active(), outer_pool);
+    CU_ASSERT_PTR_EQUAL(rmem_context_activate(outer_context), outer_context);
+
+    rmem_scope_leave(outer);
+    CU_ASSERT_PTR_NULL(rmem_pool_active());
+    CU_ASSERT_PTR_NULL(rmem_context_activate(NULL));
+
+    rmem_pool_destroy(&inner_pool);
+    rmem_pool_destroy(&outer_pool);
+    rmem_context_destroy(&inner_context);
+    rmem_context_destroy(&outer_context);
+}
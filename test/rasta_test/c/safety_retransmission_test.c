@@ -3,6 +3,7 @@
 
 #include "../../../src/c/rasta_connection.h"
 #include "../../../src/c/retransmission/safety_retransmission.h"
+#include "../../../src/c/transport/events.h"
 #include "../../../src/c/transport/transport.h"
 #include "../../../src/c/util/rmemory.h"
 
@@ -54,6 +55,7 @@ void test_sr_retransmit_data_shouldSendFinalHeartbeat() {
     fake_channel.hashing_context.algorithm = RASTA_ALGO_MD4;
     fake_channel.hashing_context.hash_length = RASTA_CHECKSUM_NONE;
     fake_channel.seq_tx = 0;
+    fake_channel.checksum_type = info.redundancy.crc_type;
     rasta_md4_set_key(&fake_channel.hashing_context, 0, 0, 0, 0);
 
     rasta_transport_channel transport;
@@ -69,7 +71,7 @@ void test_sr_retransmit_data_shouldSendFinalHeartbeat() {
 
     rasta_connection connection;
     connection.remote_id = SERVER_ID;
-    connection.fifo_retransmission = fifo_init(0);
+    connection.retransmission_store = retransmission_store_init(0);
     connection.redundancy_channel = &fake_channel;
     connection.config = &info;
     connection.logger = &logger;
@@ -85,7 +87,7 @@ void test_sr_retransmit_data_shouldSendFinalHeartbeat() {
     // 8 bytes retransmission header, 2 bytes offset for message type
     CU_ASSERT_EQUAL(RASTA_TYPE_HB, leShortToHost(hb_message->bytes + 8 + 2));
 
-    fifo_destroy(&connection.fifo_retransmission);
+    retransmission_store_destroy(&connection.retransmission_store);
 
     freeRastaByteArray(hb_message);
     rfree(hb_message);
@@ -127,6 +129,7 @@ void test_sr_retransmit_data_shouldRetransmitPackage() {
     fake_channel.hashing_context.algorithm = RASTA_ALGO_MD4;
     fake_channel.hashing_context.hash_length = RASTA_CHECKSUM_NONE;
     fake_channel.seq_tx = 0;
+    fake_channel.checksum_type = info.redundancy.crc_type;
     rasta_md4_set_key(&fake_channel.hashing_context, 0, 0, 0, 0);
 
     rasta_transport_channel transport;
@@ -142,10 +145,11 @@ void test_sr_retransmit_data_shouldRetransmitPackage() {
 
     struct rasta_connection connection;
     connection.remote_id = SERVER_ID;
-    connection.fifo_retransmission = fifo_init(1);
+    connection.retransmission_store = retransmission_store_init(1);
     connection.redundancy_channel = &fake_channel;
     connection.config = &info;
     connection.logger = &logger;
+    connection.sn_t = 5;
 
     struct RastaMessageData app_messages;
     struct RastaByteArray message;
@@ -162,11 +166,7 @@ void test_sr_retransmit_data_shouldRetransmitPackage() {
 
     struct RastaPacket data = createDataMessage(SERVER_ID, 0, 0, 0, 0, 0, app_messages, &hashing_context);
     struct RastaByteArray packet = rastaModuleToBytes(&data, &hashing_context);
-    struct RastaByteArray *to_fifo = rmalloc(sizeof(struct RastaByteArray));
-    allocateRastaByteArray(to_fifo, packet.length);
-    rmemcpy(to_fifo->bytes, packet.bytes, packet.length);
-    fifo_push(connection.fifo_retransmission, to_fifo);
-    freeRastaByteArray(&packet);
+    retransmission_store_push(connection.retransmission_store, data.sequence_number, data.timestamp, packet, 0, packet.length);
 
     // Act
     sr_retransmit_data(&connection);
@@ -174,7 +174,10 @@ void test_sr_retransmit_data_shouldRetransmitPackage() {
     // Assert
 
     // Retransmission queue should still contain 1 (unconfirmed) packet
-    CU_ASSERT_EQUAL(1, fifo_get_size(connection.fifo_retransmission));
+    CU_ASSERT_EQUAL(1, retransmission_store_size(connection.retransmission_store));
+    // and it is kept under its new sequence number
+    struct retransmission_entry *entry = retransmission_store_get(connection.retransmission_store, 0);
+    CU_ASSERT_EQUAL(5, entry->sequence_number);
 
     // Two messages should be sent
     CU_ASSERT_PTR_NOT_NULL_FATAL(test_send_fifo);
@@ -184,6 +187,7 @@ void test_sr_retransmit_data_shouldRetransmitPackage() {
     CU_ASSERT_PTR_NOT_NULL(retrdata_message);
     CU_ASSERT_EQUAL(8 + 42, retrdata_message->length);
     CU_ASSERT_EQUAL(RASTA_TYPE_RETRDATA, leShortToHost(retrdata_message->bytes + 8 + 2));
+    CU_ASSERT_EQUAL(5, leLongToHost(retrdata_message->bytes + 8 + 12));
     // Contains 'Hello world'
     CU_ASSERT_EQUAL(message.length, leShortToHost(retrdata_message->bytes + 8 + 28));
     CU_ASSERT_EQUAL(0, memcmp(retrdata_message->bytes + 8 + 28 + 2, message.bytes, message.length));
@@ -192,7 +196,7 @@ void test_sr_retransmit_data_shouldRetransmitPackage() {
     CU_ASSERT_EQUAL(8 + 28, hb_message->length);
     CU_ASSERT_EQUAL(RASTA_TYPE_HB, leShortToHost(hb_message->bytes + 8 + 2));
 
-    fifo_destroy(&connection.fifo_retransmission);
+    retransmission_store_destroy(&connection.retransmission_store);
     fifo_destroy(&test_send_fifo);
 
     freeRastaByteArray(retrdata_message);
@@ -240,6 +244,7 @@ void test_sr_handle_conreq_shouldInitializeSequenceNumberFromConfig() {
     fake_channel.hashing_context.algorithm = RASTA_ALGO_MD4;
     fake_channel.hashing_context.hash_length = RASTA_CHECKSUM_NONE;
     fake_channel.seq_tx = 0;
+    fake_channel.checksum_type = info.redundancy.crc_type;
     rasta_md4_set_key(&fake_channel.hashing_context, 0, 0, 0, 0);
 
     rasta_transport_channel transport;
@@ -256,7 +261,7 @@ void test_sr_handle_conreq_shouldInitializeSequenceNumberFromConfig() {
     struct rasta_connection connection;
     connection.my_id = SERVER_ID;
     connection.remote_id = CLIENT_ID;
-    connection.fifo_retransmission = fifo_init(1);
+    connection.retransmission_store = retransmission_store_init(1);
     connection.redundancy_channel = &fake_channel;
     connection.config = &info;
     connection.logger = &logger;
@@ -286,7 +291,7 @@ void test_sr_handle_conreq_shouldInitializeSequenceNumberFromConfig() {
     CU_ASSERT_EQUAL(RASTA_TYPE_CONNRESP, leShortToHost(connresp_message->bytes + 8 + 2));
     CU_ASSERT_EQUAL(42, leShortToHost(connresp_message->bytes + 8 + 12));
 
-    fifo_destroy(&connection.fifo_retransmission);
+    retransmission_store_destroy(&connection.retransmission_store);
     fifo_destroy(&test_send_fifo);
 
     freeRastaByteArray(connresp_message);
@@ -296,3 +301,139 @@ void test_sr_handle_conreq_shouldInitializeSequenceNumberFromConfig() {
     freeRastaByteArray(&fake_channel.hashing_context.key);
     freeRastaByteArray(&mux.sr_hashing_context.key);
 }
+
+void test_sr_reserve_message_shouldRejectOversizedMessage() {
+    struct logger_t logger;
+    logger_init(&logger, LOG_LEVEL_INFO, LOGGER_TYPE_CONSOLE);
+
+    rasta_config_info info = {0};
+    info.redundancy.crc_type = crc_init_opt_b();
+
+    rasta_redundancy_channel fake_channel;
+    fake_channel.hashing_context.hash_length = RASTA_CHECKSUM_8B;
+
+    struct rasta_connection connection;
+    connection.redundancy_channel = &fake_channel;
+    connection.config = &info;
+    connection.logger = &logger;
+
+    // the redundancy PDU length is a 16 bit field: 8 bytes redundancy header and the 4 byte CRC around the SR PDU,
+    // which has 28 bytes header, 2 bytes message length and the 8 byte safety code around the message
+    CU_ASSERT_EQUAL(UINT16_MAX - 8 - 4, sr_max_pdu_length(&connection));
+    CU_ASSERT_EQUAL(UINT16_MAX - 8 - 4 - 28 - 2 - 8, sr_max_message_length(&connection));
+
+    unsigned char *message = sr_reserve_message(&connection, sr_max_message_length(&connection));
+    CU_ASSERT_PTR_NOT_NULL(message);
+    sr_release_message(message);
+
+    CU_ASSERT_PTR_NULL(sr_reserve_message(&connection, sr_max_message_length(&connection) + 1));
+    CU_ASSERT_PTR_NULL(sr_reserve_message(&connection, (size_t)UINT32_MAX + 1));
+}
+
+void test_sr_queue_submitted_shouldKeepMessagesWhileRetransmissionStoreIsFull() {
+    fifo_destroy(&test_send_fifo);
+
+    struct rasta_handle rasta_h = {0};
+
+    struct logger_t logger;
+    logger_init(&logger, LOG_LEVEL_INFO, LOGGER_TYPE_CONSOLE);
+
+    rasta_config_info info = {0};
+    info.redundancy.t_seq = 100;
+    info.redundancy.n_diagnose = 10;
+    info.redundancy.crc_type = crc_init_opt_a();
+    info.redundancy.n_deferqueue_size = 2;
+    info.retransmission.max_retransmission_queue_size = 2;
+    info.sending.max_packet = 1;
+
+    redundancy_mux mux;
+    redundancy_mux_alloc(&rasta_h, &mux, &logger, &info);
+    mux.sr_hashing_context.hash_length = RASTA_CHECKSUM_NONE;
+    rasta_md4_set_key(&mux.sr_hashing_context, 0, 0, 0, 0);
+
+    rasta_redundancy_channel fake_channel;
+    fake_channel.mux = &mux;
+    fake_channel.associated_id = SERVER_ID;
+    fake_channel.hashing_context.algorithm = RASTA_ALGO_MD4;
+    fake_channel.hashing_context.hash_length = RASTA_CHECKSUM_NONE;
+    fake_channel.seq_tx = 0;
+    fake_channel.checksum_type = info.redundancy.crc_type;
+    rasta_md4_set_key(&fake_channel.hashing_context, 0, 0, 0, 0);
+
+    rasta_transport_channel transport;
+    transport.send_callback = fake_send_callback;
+    transport.connected = true;
+    transport.remote_port = 1234;
+    strncpy(transport.remote_ip_address, "127.0.0.1", 10);
+
+    fake_channel.transport_channels = &transport;
+    fake_channel.transport_channel_count = 1;
+
+    mux.redundancy_channel = &fake_channel;
+
+    struct rasta_connection connection;
+    memset(&connection, 0, sizeof(connection));
+    connection.remote_id = SERVER_ID;
+    connection.current_state = RASTA_CONNECTION_UP;
+    connection.retransmission_store = retransmission_store_init(info.retransmission.max_retransmission_queue_size);
+    connection.fifo_send = fifo_init(2 * info.sending.max_packet);
+    connection.submit_queue = mpsc_queue_init(16);
+    connection.redundancy_channel = &fake_channel;
+    connection.config = &info;
+    connection.logger = &logger;
+    connection.send_handle.connection = &connection;
+    connection.send_handle.config = &info.sending;
+    connection.send_handle.logger = &logger;
+    connection.send_handle.hashing_context = &mux.sr_hashing_context;
+
+    // more messages than the send queue and the retransmission store can hold
+    const unsigned char message_count = 10;
+    for (unsigned char i = 0; i < message_count; i++) {
+        struct RastaByteArray *msg = rmalloc(sizeof(struct RastaByteArray));
+        allocateRastaByteArray(msg, 1);
+        msg->bytes[0] = i;
+        CU_ASSERT_TRUE(mpsc_queue_push(connection.submit_queue, msg));
+    }
+
+    // Act
+    sr_queue_submitted(&connection);
+
+    // Assert
+
+    // two PDUs fill the retransmission store, two messages wait in the send queue and the rest stays submitted
+    CU_ASSERT_PTR_NOT_NULL_FATAL(test_send_fifo);
+    CU_ASSERT_EQUAL(2, fifo_get_size(test_send_fifo));
+    CU_ASSERT_EQUAL(2, fifo_get_size(connection.fifo_send));
+    CU_ASSERT_PTR_NOT_NULL(connection.submit_carry);
+
+    // confirming the sent PDUs lets the remaining messages follow
+    for (unsigned int round = 0; round < 2 * message_count && (connection.submit_carry != NULL || fifo_get_size(connection.fifo_send) > 0); round++) {
+        connection.cs_r = connection.sn_t - 1;
+        sr_remove_confirmed_messages(&connection);
+        // the send timer
+        data_send_event(&connection.send_handle, -1);
+    }
+
+    CU_ASSERT_PTR_NULL(connection.submit_carry);
+    CU_ASSERT_PTR_NULL(mpsc_queue_pop(connection.submit_queue));
+    CU_ASSERT_EQUAL(message_count, fifo_get_size(test_send_fifo));
+
+    // every message arrives once and in the order it was submitted
+    for (unsigned char i = 0; i < message_count; i++) {
+        struct RastaByteArray *pdu = fifo_pop(test_send_fifo);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(pdu);
+        CU_ASSERT_EQUAL(RASTA_TYPE_DATA, leShortToHost(pdu->bytes + 8 + 2));
+        CU_ASSERT_EQUAL(1, leShortToHost(pdu->bytes + 8 + 28));
+        CU_ASSERT_EQUAL(i, pdu->bytes[8 + 28 + 2]);
+        freeRastaByteArray(pdu);
+        rfree(pdu);
+    }
+
+    retransmission_store_destroy(&connection.retransmission_store);
+    fifo_destroy(&connection.fifo_send);
+    mpsc_queue_destroy(&connection.submit_queue);
+    fifo_destroy(&test_send_fifo);
+
+    freeRastaByteArray(&fake_channel.hashing_context.key);
+    freeRastaByteArray(&mux.sr_hashing_context.key);
+}
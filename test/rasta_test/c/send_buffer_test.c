@@ -0,0 +1,72 @@
+#include "send_buffer_test.h"
+#include "../../src/c/util/send_buffer.h"
+#include <CUnit/Basic.h>
+#include <string.h>
+
+void test_send_buffer_push_consume() {
+    send_buffer_t buffer;
+    send_buffer_init(&buffer, 16);
+    struct iovec iov[2];
+    CU_ASSERT_EQUAL(send_buffer_iov(&buffer, iov), 0);
+    CU_ASSERT_PTR_NULL(buffer.data);
+
+    unsigned char bytes[16];
+    memset(bytes, 1, sizeof(bytes));
+    CU_ASSERT_TRUE(send_buffer_push(&buffer, bytes, 10));
+    CU_ASSERT_EQUAL(send_buffer_iov(&buffer, iov), 1);
+    CU_ASSERT_EQUAL(iov[0].iov_len, 10);
+
+    // data is only added as a whole
+    CU_ASSERT_FALSE(send_buffer_push(&buffer, bytes, 7));
+    CU_ASSERT_EQUAL(buffer.size, 10);
+    CU_ASSERT_TRUE(send_buffer_push(&buffer, bytes, 6));
+    CU_ASSERT_EQUAL(buffer.size, 16);
+
+    // a partial write keeps the rest in order
+    send_buffer_consume(&buffer, 4);
+    CU_ASSERT_EQUAL(send_buffer_iov(&buffer, iov), 1);
+    CU_ASSERT_EQUAL(iov[0].iov_len, 12);
+    CU_ASSERT_PTR_EQUAL(iov[0].iov_base, &buffer.data[4]);
+
+    // an empty buffer starts at the beginning again
+    send_buffer_consume(&buffer, 12);
+    CU_ASSERT_EQUAL(buffer.head, 0);
+    CU_ASSERT_EQUAL(send_buffer_iov(&buffer, iov), 0);
+
+    send_buffer_destroy(&buffer);
+    CU_ASSERT_PTR_NULL(buffer.data);
+}
+
+void test_send_buffer_wrap_around() {
+    send_buffer_t buffer;
+    send_buffer_init(&buffer, 16);
+
+    unsigned char first[12];
+    unsigned char second[8];
+    memset(first, 1, sizeof(first));
+    memset(second, 2, sizeof(second));
+
+    CU_ASSERT_TRUE(send_buffer_push(&buffer, first, sizeof(first)));
+    send_buffer_consume(&buffer, 10);
+
+    // the bytes wrap around the end of the ring and are described by two areas
+    CU_ASSERT_TRUE(send_buffer_push(&buffer, second, sizeof(second)));
+    struct iovec iov[2];
+    CU_ASSERT_EQUAL(send_buffer_iov(&buffer, iov), 2);
+    CU_ASSERT_EQUAL(iov[0].iov_len, 6);
+    CU_ASSERT_EQUAL(iov[1].iov_len, 4);
+    CU_ASSERT_PTR_EQUAL(iov[1].iov_base, buffer.data);
+
+    unsigned char *area = iov[0].iov_base;
+    CU_ASSERT_EQUAL(area[0], 1);
+    CU_ASSERT_EQUAL(area[1], 1);
+    CU_ASSERT_EQUAL(area[2], 2);
+    CU_ASSERT_EQUAL(buffer.data[3], 2);
+
+    send_buffer_consume(&buffer, 6);
+    CU_ASSERT_EQUAL(send_buffer_iov(&buffer, iov), 1);
+    CU_ASSERT_EQUAL(iov[0].iov_len, 4);
+    CU_ASSERT_PTR_EQUAL(iov[0].iov_base, buffer.data);
+
+    send_buffer_destroy(&buffer);
+}
@@ -0,0 +1,103 @@
+#include "udp_batch_test.h"
+#include "../../src/c/transport/bsd_utils.h"
+#include "../../src/c/transport/udp.h"
+#include <CUnit/Basic.h>
+#include <string.h>
+
+#define TEST_PORT_SENDER 9871
+#define TEST_PORT_RECEIVER 9872
+
+void test_udp_batch_send_receive() {
+    rasta_transport_socket sender, receiver;
+    memset(&sender, 0, sizeof(sender));
+    memset(&receiver, 0, sizeof(receiver));
+    sender.file_descriptor = bsd_create_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    receiver.file_descriptor = bsd_create_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    CU_ASSERT_TRUE(bsd_bind_device(sender.file_descriptor, TEST_PORT_SENDER, "127.0.0.1"));
+    CU_ASSERT_TRUE(bsd_bind_device(receiver.file_descriptor, TEST_PORT_RECEIVER, "127.0.0.1"));
+
+    rasta_transport_channel channel;
+    memset(&channel, 0, sizeof(channel));
+    channel.file_descriptor = sender.file_descriptor;
+    channel.associated_socket = &sender;
+
+    // more datagrams than fit into one batch, the first batch is sent when it is full
+    udp_cork(&sender);
+    for (unsigned char i = 0; i < UDP_BATCH_SIZE + 2; i++) {
+        unsigned char message[3] = {i, i, i};
+        udp_send(&channel, message, i % 3 + 1, "127.0.0.1", TEST_PORT_RECEIVER);
+    }
+    udp_flush(&sender);
+
+    CU_ASSERT_FALSE(udp_receive_pending(&receiver));
+    for (unsigned char i = 0; i < UDP_BATCH_SIZE + 2; i++) {
+        unsigned char buffer[8] = {0};
+        struct sockaddr_in from;
+        size_t len = udp_receive(&receiver, buffer, sizeof(buffer), &from);
+        CU_ASSERT_EQUAL(len, i % 3 + 1);
+        CU_ASSERT_EQUAL(buffer[0], i);
+        CU_ASSERT_EQUAL(ntohs(from.sin_port), TEST_PORT_SENDER);
+        if (i == 0) {
+            // the rest of the first batch has been read together with the first datagram
+            CU_ASSERT_TRUE(udp_receive_pending(&receiver));
+        }
+    }
+    CU_ASSERT_FALSE(udp_receive_pending(&receiver));
+
+    // uncorked messages are sent right away
+    unsigned char message[1] = {42};
+    udp_send(&channel, message, 1, "127.0.0.1", TEST_PORT_RECEIVER);
+    unsigned char buffer[8] = {0};
+    struct sockaddr_in from;
+    CU_ASSERT_EQUAL(udp_receive(&receiver, buffer, sizeof(buffer), &from), 1);
+    CU_ASSERT_EQUAL(buffer[0], 42);
+
+    udp_close(&sender);
+    udp_close(&receiver);
+    CU_ASSERT_PTR_NULL(sender.batch);
+    CU_ASSERT_PTR_NULL(receiver.batch);
+}
+
+void test_udp_batch_offload() {
+    rasta_transport_socket sender, receiver;
+    memset(&sender, 0, sizeof(sender));
+    memset(&receiver, 0, sizeof(receiver));
+    sender.file_descriptor = bsd_create_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    receiver.file_descriptor = bsd_create_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    CU_ASSERT_TRUE(bsd_bind_device(sender.file_descriptor, TEST_PORT_SENDER, "127.0.0.1"));
+    CU_ASSERT_TRUE(bsd_bind_device(receiver.file_descriptor, TEST_PORT_RECEIVER, "127.0.0.1"));
+
+    // without kernel support, the datagrams are sent and received individually
+    udp_enable_offload(&sender);
+    udp_enable_offload(&receiver);
+
+    rasta_transport_channel channel;
+    memset(&channel, 0, sizeof(channel));
+    channel.file_descriptor = sender.file_descriptor;
+    channel.associated_socket = &sender;
+
+    // a run of equal-sized datagrams, followed by a shorter one
+    unsigned char lengths[] = {36, 36, 36, 36, 36, 20};
+    unsigned int count = sizeof(lengths);
+
+    udp_cork(&sender);
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned char message[36];
+        memset(message, (int)i, sizeof(message));
+        udp_send(&channel, message, lengths[i], "127.0.0.1", TEST_PORT_RECEIVER);
+    }
+    udp_flush(&sender);
+
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned char buffer[64] = {0};
+        struct sockaddr_in from;
+        CU_ASSERT_EQUAL(udp_receive(&receiver, buffer, sizeof(buffer), &from), lengths[i]);
+        CU_ASSERT_EQUAL(buffer[0], i);
+        CU_ASSERT_EQUAL(buffer[lengths[i] - 1], i);
+        CU_ASSERT_EQUAL(ntohs(from.sin_port), TEST_PORT_SENDER);
+    }
+    CU_ASSERT_FALSE(udp_receive_pending(&receiver));
+
+    udp_close(&sender);
+    udp_close(&receiver);
+}
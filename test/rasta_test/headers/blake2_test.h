@@ -1,2 +1,3 @@
 #pragma once
 void testBlake2Hash();
+void testHashingContextKeyedState();
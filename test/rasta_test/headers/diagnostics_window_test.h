@@ -0,0 +1,5 @@
+#pragma once
+
+void test_diagnostics_window_add_get();
+
+void test_diagnostics_window_slide();
@@ -0,0 +1,15 @@
+#pragma once
+
+void test_event_system_timer_order();
+
+void test_event_system_timer_remove();
+
+void test_event_system_timer_reschedule();
+
+void test_event_system_run_once_keeps_phase();
+
+void test_event_system_run_once_rebases_late_timer();
+
+#ifdef USE_EPOLL
+void test_event_system_fd_timer();
+#endif
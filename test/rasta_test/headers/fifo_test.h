@@ -3,3 +3,7 @@
 void test_push();
 
 void test_pop();
+
+void test_wrap_around();
+
+void test_oversized();
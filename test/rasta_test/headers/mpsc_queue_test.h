@@ -0,0 +1,9 @@
+#pragma once
+
+void test_mpsc_queue_push_pop();
+
+void test_mpsc_queue_full();
+
+void test_mpsc_queue_multiple_producers();
+
+void test_mpsc_queue_oversized();
@@ -4,5 +4,8 @@ void test_opt_b();
 void test_opt_c();
 void test_opt_d();
 void test_opt_e();
+void test_opt_c_long();
+void test_long_inputs();
+void test_kernel_selection();
 
 void test_without_gen_table();
@@ -53,7 +53,7 @@ void test_deferqueue_get();
 /**
  * test if the array is sorted after add and delete
  */
-void test_deferqueue_sorted();
+void test_deferqueue_sequence_window();
 
 /**
  * test if the array is empty after calling clear
@@ -3,3 +3,5 @@
 void testMD4function();
 
 void testRastaMD4Sample();
+
+void testMD4Batch();
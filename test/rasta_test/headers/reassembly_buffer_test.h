@@ -0,0 +1,7 @@
+#pragma once
+
+void test_reassembly_buffer_partial();
+
+void test_reassembly_buffer_wrap_around();
+
+void test_reassembly_buffer_grow();
@@ -0,0 +1,7 @@
+#pragma once
+
+void test_retransmission_store_push_pop();
+
+void test_retransmission_store_confirm();
+
+void test_retransmission_store_wrap_around();
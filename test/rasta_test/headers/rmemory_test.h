@@ -0,0 +1,11 @@
+#pragma once
+
+void test_rmem_pool_reuse();
+
+void test_rmem_pool_oversized();
+
+void test_rmem_pool_destroy_in_use();
+
+void test_rmem_context_allocator();
+
+void test_rmem_scope();
@@ -2,3 +2,5 @@
 void test_sr_retransmit_data_shouldSendFinalHeartbeat();
 void test_sr_retransmit_data_shouldRetransmitPackage();
 void test_sr_handle_conreq_shouldInitializeSequenceNumberFromConfig();
+void test_sr_reserve_message_shouldRejectOversizedMessage();
+void test_sr_queue_submitted_shouldKeepMessagesWhileRetransmissionStoreIsFull();
@@ -0,0 +1,5 @@
+#pragma once
+
+void test_send_buffer_push_consume();
+
+void test_send_buffer_wrap_around();
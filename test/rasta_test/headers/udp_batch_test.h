@@ -0,0 +1,5 @@
+#pragma once
+
+void test_udp_batch_send_receive();
+
+void test_udp_batch_offload();
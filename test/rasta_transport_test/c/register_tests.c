@@ -60,6 +60,14 @@ void cunit_register() {
     CU_add_test(pSuiteMath, "test_transport_redial_should_reconnect", test_transport_redial_should_reconnect);
     CU_add_test(pSuiteMath, "test_transport_redial_should_assign_new_fds", test_transport_redial_should_assign_new_fds);
     CU_add_test(pSuiteMath, "test_transport_redial_should_update_event_fds", test_transport_redial_should_update_event_fds);
+
+#ifndef ENABLE_TLS
+    // Tests for receive_callback
+    CU_add_test(pSuiteMath, "test_receive_callback_should_reassemble_pdus", test_receive_callback_should_reassemble_pdus);
+
+    // Tests for send_callback
+    CU_add_test(pSuiteMath, "test_send_callback_should_queue_when_socket_is_full", test_send_callback_should_queue_when_socket_is_full);
+#endif
 #endif
 
 #ifdef TEST_UDP
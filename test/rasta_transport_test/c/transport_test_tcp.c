@@ -2,7 +2,11 @@
 #include "mock_socket.h"
 
 #include <CUnit/Basic.h>
+#include <fcntl.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include "../../../src/c/rastahandle.h"
 #include "../../src/c/transport/transport.h"
@@ -334,3 +338,132 @@ void test_transport_redial_should_update_event_fds() {
     CU_ASSERT_EQUAL(socket.accept_event.fd, socket.file_descriptor);
     CU_ASSERT_EQUAL(socket.receive_event.fd, socket.file_descriptor);
 }
+
+#ifndef ENABLE_TLS
+static void write_pdu_bytes(int fd, const unsigned char *pdus, size_t length) {
+    CU_ASSERT_EQUAL(write(fd, pdus, length), (ssize_t)length);
+}
+
+void test_receive_callback_should_reassemble_pdus() {
+    // Arrange
+    int fds[2];
+    CU_ASSERT_EQUAL(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    rasta_transport_channel channel = {0};
+    channel.file_descriptor = fds[0];
+    channel.connected = true;
+    struct receive_event_data data = {0};
+    data.channel = &channel;
+
+    // three PDUs with a length prefix of 10, 12 and 8 bytes
+    unsigned char stream[30] = {0};
+    stream[0] = 10;
+    stream[10] = 12;
+    stream[22] = 8;
+    for (unsigned char i = 2; i < 10; i++) {
+        stream[i] = 1;
+    }
+
+    unsigned char scratch[8];
+    unsigned char *buffer = scratch;
+    struct sockaddr_in sender;
+
+    // Act: the first PDU and a part of the second one
+    write_pdu_bytes(fds[1], stream, 13);
+    ssize_t len = receive_callback(&data, &buffer, &sender);
+
+    // Assert
+    CU_ASSERT_EQUAL(len, 10);
+    CU_ASSERT_EQUAL(buffer[0], 10);
+    CU_ASSERT_EQUAL(buffer[9], 1);
+    CU_ASSERT_FALSE(transport_receive_pending(&data));
+
+    // Act: a single byte does not complete the second PDU
+    write_pdu_bytes(fds[1], &stream[13], 1);
+    buffer = scratch;
+    CU_ASSERT_EQUAL(receive_callback(&data, &buffer, &sender), 0);
+
+    // Act: the rest of the second and the third PDU arrive together
+    write_pdu_bytes(fds[1], &stream[14], 16);
+    buffer = scratch;
+    len = receive_callback(&data, &buffer, &sender);
+
+    // Assert: the third PDU is handed out by the next call without reading
+    CU_ASSERT_EQUAL(len, 12);
+    CU_ASSERT_EQUAL(buffer[0], 12);
+    CU_ASSERT_TRUE(transport_receive_pending(&data));
+    buffer = scratch;
+    CU_ASSERT_EQUAL(receive_callback(&data, &buffer, &sender), 8);
+    CU_ASSERT_EQUAL(buffer[0], 8);
+    CU_ASSERT_FALSE(transport_receive_pending(&data));
+
+    // Act: the peer closes the stream
+    close(fds[1]);
+    buffer = scratch;
+
+    // Assert
+    CU_ASSERT_EQUAL(receive_callback(&data, &buffer, &sender), -1);
+
+    close(fds[0]);
+    transport_free_channel(&channel);
+}
+
+void test_send_callback_should_queue_when_socket_is_full() {
+    // Arrange: a stream with a small kernel buffer that does not block
+    int fds[2];
+    CU_ASSERT_EQUAL(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    int buffer_size = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+
+    rasta_transport_channel channel = {0};
+    channel.file_descriptor = fds[0];
+    channel.connected = true;
+    channel.receive_event.options = EV_READABLE;
+
+    // three PDUs that are filled with 1, 2 and 3
+    unsigned char pdu[60000];
+    struct RastaByteArray data;
+    data.bytes = pdu;
+    data.length = sizeof(pdu);
+
+    // Act
+    for (unsigned char i = 1; i <= 3; i++) {
+        memset(pdu, i, sizeof(pdu));
+        send_callback(data, &channel);
+    }
+
+    // Assert: the rest is queued, application data is held back and the channel waits for writability
+    CU_ASSERT_TRUE(channel.send_buffer.size > 0);
+    CU_ASSERT_FALSE(transport_can_send(&channel));
+    CU_ASSERT_EQUAL(channel.receive_event.options, EV_READABLE | EV_WRITABLE);
+
+    // Act: the peer reads while the queued data is written
+    unsigned char received[3 * sizeof(pdu)];
+    size_t received_len = 0;
+    while (received_len < sizeof(received)) {
+        ssize_t len = read(fds[1], &received[received_len], sizeof(received) - received_len);
+        CU_ASSERT_TRUE(len > 0);
+        if (len <= 0) {
+            break;
+        }
+        received_len += (size_t)len;
+        transport_send_queued(&channel);
+    }
+
+    // Assert: the stream arrives complete and in order
+    CU_ASSERT_EQUAL(received_len, sizeof(received));
+    CU_ASSERT_EQUAL(received[0], 1);
+    CU_ASSERT_EQUAL(received[sizeof(pdu) - 1], 1);
+    CU_ASSERT_EQUAL(received[sizeof(pdu)], 2);
+    CU_ASSERT_EQUAL(received[2 * sizeof(pdu)], 3);
+    CU_ASSERT_EQUAL(received[sizeof(received) - 1], 3);
+    CU_ASSERT_EQUAL(channel.send_buffer.size, 0);
+    CU_ASSERT_TRUE(transport_can_send(&channel));
+    CU_ASSERT_EQUAL(channel.receive_event.options, EV_READABLE);
+
+    close(fds[0]);
+    close(fds[1]);
+    transport_free_channel(&channel);
+}
+#endif
@@ -15,3 +15,9 @@ void test_transport_close_channel_should_disable_channel_receive_event();
 void test_transport_redial_should_reconnect();
 void test_transport_redial_should_assign_new_fds();
 void test_transport_redial_should_update_event_fds();
+
+#ifndef ENABLE_TLS
+void test_receive_callback_should_reassemble_pdus();
+
+void test_send_callback_should_queue_when_socket_is_full();
+#endif